@@ -0,0 +1,290 @@
+#include "Agent.h"
+#include "Colors.h"
+#include "Console.h"
+#include "Battle.h"
+#include "Latency.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static bool at(const Observation& observation, Game::Prompt prompt) {
+    return observation.prompt == static_cast<int>(prompt);
+}
+
+static bool offers(const Observation& observation, const std::string& action) {
+    const std::vector<std::string>& legal = observation.legalActions;
+    return std::find(legal.begin(), legal.end(), action) != legal.end();
+}
+
+BotSession::BotSession() : game(input), discard(nullptr) {
+    game.disableSaving();
+    Colors::setAnimationsEnabled(false);
+    Console::redirect(&discard);
+    game.start();
+    Console::redirect(nullptr);
+}
+
+void BotSession::observe(Observation& observation, int windowRadius) const {
+    game.observe(observation, windowRadius);
+}
+
+void BotSession::act(const std::string& action) {
+    Console::redirect(&discard);
+    game.feed(action);
+    Console::redirect(nullptr);
+}
+
+std::string RandomAgent::choose(const Observation& observation) {
+    if (at(observation, Game::Prompt::MAIN_MENU)) {
+        return "1";
+    }
+    std::vector<std::string> choices;
+    for (const std::string& action : observation.legalActions) {
+        if (!(at(observation, Game::Prompt::COMMAND) && action == "Q")) {
+            choices.push_back(action);
+        }
+    }
+    if (choices.empty()) {
+        return "";
+    }
+    return choices[rng() % choices.size()];
+}
+
+ScriptedAgent::ScriptedAgent(unsigned seed, int classChoice)
+    : rng(seed), playerClass(std::to_string(classChoice)), travels(0) {
+}
+
+// Three levels per region before moving on
+bool ScriptedAgent::wantsToTravel(const Observation& observation) const {
+    return observation.level >= 3 * (travels + 1);
+}
+
+bool ScriptedAgent::readyForCastle(const Observation& observation) const {
+    return observation.level >= 3 * (travels + 1) && observation.health == observation.maxHealth;
+}
+
+std::string ScriptedAgent::choose(const Observation& observation) {
+    switch (static_cast<Game::Prompt>(observation.prompt)) {
+        case Game::Prompt::MAIN_MENU: return "1";
+        case Game::Prompt::NAME: return "Bot";
+        case Game::Prompt::CLASS: return playerClass;
+        case Game::Prompt::COMMAND: return onCommand(observation);
+        case Game::Prompt::TOWN: return onTown(observation);
+        case Game::Prompt::SHOP: return observation.gold >= 20 ? "Health Potion" : "leave";
+        case Game::Prompt::DUNGEON: return observation.health == observation.maxHealth ? "y" : "n";
+        case Game::Prompt::CASTLE: return readyForCastle(observation) ? "y" : "n";
+        case Game::Prompt::BATTLE: return onBattle(observation);
+        case Game::Prompt::SAVE_ON_QUIT: return "n";
+        case Game::Prompt::USE_ITEM: return "no";
+        case Game::Prompt::PROFILE: return "1";
+        default: return "";
+    }
+}
+
+std::string ScriptedAgent::onCommand(const Observation& observation) {
+    bool finalRegion = false;
+    for (const std::string& row : observation.mapWindow) {
+        if (row.find('C') != std::string::npos) {
+            finalRegion = true;
+        }
+    }
+    if (observation.health * 5 < observation.maxHealth * 3) {
+        return stepToward(observation, 'T'); // rest before something kills us
+    }
+    if (finalRegion) {
+        return readyForCastle(observation) ? stepToward(observation, 'C') : wander(observation);
+    }
+    return wantsToTravel(observation) ? stepToward(observation, 'T') : wander(observation);
+}
+
+std::string ScriptedAgent::onTown(const Observation& observation) {
+    if (observation.health < observation.maxHealth) {
+        return "2";
+    }
+    if (offers(observation, "4") && wantsToTravel(observation)) {
+        travels++;
+        return "4";
+    }
+    if (observation.gold >= 20 && observation.potions < 5) {
+        return "1";
+    }
+    return "3";
+}
+
+std::string ScriptedAgent::onBattle(const Observation& observation) {
+    switch (static_cast<Battle::Prompt>(observation.battlePrompt)) {
+        case Battle::Prompt::ACTION:
+            if (observation.potions > 0 && observation.health * 3 < observation.maxHealth) {
+                return "4";
+            }
+            // The first skill outdoes a plain attack for every class
+            return observation.mana >= 15 && offers(observation, "2") ? "2" : "1";
+        case Battle::Prompt::SKILL:
+            return offers(observation, "1") ? "1" : "0";
+        case Battle::Prompt::ITEM:
+            return offers(observation, "Health Potion") ? "Health Potion" : "cancel";
+        default:
+            return "0";
+    }
+}
+
+// First step of a shortest path to the nearest `goal` tile other than the
+// one we stand on; stepping off and back on re-enters a town
+std::string ScriptedAgent::stepToward(const Observation& observation, char goal) {
+    const std::vector<std::string>& window = observation.mapWindow;
+    int size = static_cast<int>(window.size());
+    int centre = observation.windowRadius;
+    if (size == 0) {
+        return wander(observation);
+    }
+    auto passable = [&](int x, int y) {
+        if (x < 0 || y < 0 || x >= size || y >= size) return false;
+        char tile = window[y][x];
+        return tile != '#' && tile != 'M' && tile != 'W' && tile != ' ';
+    };
+
+    static const int dx[4] = {0, -1, 0, 1};
+    static const int dy[4] = {-1, 0, 1, 0};
+    static const char* const keys[4] = {"W", "A", "S", "D"};
+    std::vector<int> firstMove(size * size, -1);
+    std::deque<int> frontier;
+    for (int d = 0; d < 4; d++) {
+        int x = centre + dx[d];
+        int y = centre + dy[d];
+        if (passable(x, y) && firstMove[y * size + x] < 0) {
+            firstMove[y * size + x] = d;
+            frontier.push_back(y * size + x);
+        }
+    }
+    while (!frontier.empty()) {
+        int cell = frontier.front();
+        frontier.pop_front();
+        int x = cell % size;
+        int y = cell / size;
+        if (window[y][x] == goal) {
+            return keys[firstMove[cell]];
+        }
+        for (int d = 0; d < 4; d++) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (passable(nx, ny) && firstMove[ny * size + nx] < 0 && !(nx == centre && ny == centre)) {
+                firstMove[ny * size + nx] = firstMove[cell];
+                frontier.push_back(ny * size + nx);
+            }
+        }
+    }
+    return wander(observation);
+}
+
+std::string ScriptedAgent::wander(const Observation& observation) {
+    std::vector<std::string> moves;
+    for (const char* key : {"W", "A", "S", "D"}) {
+        if (offers(observation, key)) {
+            moves.push_back(key);
+        }
+    }
+    if (moves.empty()) {
+        return "P";
+    }
+    return moves[rng() % moves.size()];
+}
+
+namespace {
+    struct Tally {
+        int victories;
+        int defeats;
+        int abandoned;   // hit the step limit
+        long long steps;
+        long long levels;
+
+        Tally() : victories(0), defeats(0), abandoned(0), steps(0), levels(0) {}
+    };
+}
+
+static void playOne(const PlaythroughOptions& options, int index, Tally& tally) {
+    std::unique_ptr<Agent> agent;
+    if (options.agent == "random") {
+        agent.reset(new RandomAgent(static_cast<unsigned>(index) * 2654435761u + 1));
+    } else {
+        agent.reset(new ScriptedAgent(static_cast<unsigned>(index) + 1, 1 + index % 3));
+    }
+
+    BotSession session;
+    Observation observation;
+    int steps = 0;
+    while (!session.isFinished() && steps < options.maxSteps) {
+        session.observe(observation, agent->windowRadius());
+        session.act(agent->choose(observation));
+        steps++;
+    }
+    session.observe(observation, 0);
+
+    tally.steps += steps;
+    tally.levels += observation.level;
+    if (session.isVictory()) {
+        tally.victories++;
+    } else if (session.isFinished()) {
+        tally.defeats++;
+    } else {
+        tally.abandoned++;
+    }
+}
+
+bool runPlaythroughs(const PlaythroughOptions& options, std::ostream& report) {
+    if (options.agent != "scripted" && options.agent != "random") {
+        report << "Unknown agent '" << options.agent << "' (use scripted or random)\n";
+        return false;
+    }
+    int threads = options.threads;
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (threads <= 0) threads = 1;
+    }
+
+    std::atomic<int> next(0);
+    std::mutex tallyMutex;
+    Tally total;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread([&] {
+            Tally mine;
+            int index;
+            while ((index = next++) < options.playthroughs) {
+                playOne(options, index, mine);
+            }
+            std::lock_guard<std::mutex> lock(tallyMutex);
+            total.victories += mine.victories;
+            total.defeats += mine.defeats;
+            total.abandoned += mine.abandoned;
+            total.steps += mine.steps;
+            total.levels += mine.levels;
+        }));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int played = options.playthroughs;
+    double rate = seconds > 0 ? played / seconds : 0;
+    report << std::fixed << std::setprecision(2);
+    report << played << " playthroughs (" << options.agent << " agents) on " << threads << " thread(s) in "
+           << seconds << " s\n";
+    report << "  victories " << total.victories << ", defeats " << total.defeats
+           << ", abandoned after " << options.maxSteps << " actions " << total.abandoned << "\n";
+    if (played > 0) {
+        report << "  average " << static_cast<double>(total.steps) / played << " actions, final level "
+               << static_cast<double>(total.levels) / played << "\n";
+    }
+    report << "  " << rate << " playthroughs/s, " << rate / threads << " per core, "
+           << (seconds > 0 ? total.steps / seconds : 0) << " actions/s\n";
+    Latency::report(report);
+    return true;
+}
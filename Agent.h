@@ -0,0 +1,84 @@
+#ifndef AGENT_H
+#define AGENT_H
+
+#include "Game.h"
+#include "CommandSource.h"
+#include "Observation.h"
+#include <string>
+#include <ostream>
+#include <random>
+
+// A game played by a program: its output is thrown away, nothing is saved,
+// and it advances one action (one line of input) at a time.
+class BotSession {
+private:
+    QueueSource input;   // unused; actions go straight to Game::feed()
+    Game game;
+    std::ostream discard;
+
+public:
+    BotSession();
+
+    void observe(Observation& observation, int windowRadius = 4) const;
+    void act(const std::string& action);
+
+    bool isFinished() const { return game.isFinished(); }
+    bool isVictory() const { return game.isVictory(); }
+};
+
+// Picks the next action from what it observes
+class Agent {
+public:
+    virtual ~Agent() {}
+    // How much of the map the agent wants to see around the player
+    virtual int windowRadius() const { return 4; }
+    virtual std::string choose(const Observation& observation) = 0;
+};
+
+// Uniformly random legal actions (never quits on purpose)
+class RandomAgent : public Agent {
+private:
+    std::minstd_rand rng;
+
+public:
+    explicit RandomAgent(unsigned seed) : rng(seed) {}
+    std::string choose(const Observation& observation) override;
+};
+
+// Plays to win: grinds battles until it is strong enough for the region,
+// rests and buys potions in towns, travels on, then walks to the castle
+// and fights the Dark Lord.
+class ScriptedAgent : public Agent {
+private:
+    std::minstd_rand rng;
+    std::string playerClass;  // "1".."3"
+    int travels;              // regions left behind so far
+
+    bool wantsToTravel(const Observation& observation) const;
+    bool readyForCastle(const Observation& observation) const;
+    std::string onCommand(const Observation& observation);
+    std::string onTown(const Observation& observation);
+    std::string onBattle(const Observation& observation);
+    std::string stepToward(const Observation& observation, char goal);
+    std::string wander(const Observation& observation);
+
+public:
+    ScriptedAgent(unsigned seed, int classChoice);
+    int windowRadius() const override { return 24; } // the whole region
+    std::string choose(const Observation& observation) override;
+};
+
+// Play complete games (character creation to victory or defeat) with
+// bots on several threads and report playthroughs per second per core
+struct PlaythroughOptions {
+    int playthroughs;
+    int threads;         // 0: one per core
+    std::string agent;   // "scripted" or "random"
+    int maxSteps;        // give up on a game after this many actions
+
+    PlaythroughOptions() : playthroughs(100), threads(0), agent("scripted"), maxSteps(20000) {}
+};
+
+bool runPlaythroughs(const PlaythroughOptions& options, std::ostream& report);
+
+#endif
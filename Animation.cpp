@@ -0,0 +1,103 @@
+#include "Animation.h"
+
+namespace Animation {
+    static thread_local Recorder* recording = nullptr;
+
+    int Recorder::overflow(int c) {
+        if (c != traits_type::eof()) {
+            current += static_cast<char>(c);
+            bytes++;
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize Recorder::xsputn(const char* data, std::streamsize count) {
+        current.append(data, static_cast<size_t>(count));
+        bytes += static_cast<size_t>(count);
+        return count;
+    }
+
+    void Recorder::hold(int ms) {
+        if (ms <= 0) {
+            return;
+        }
+        if (current.empty() && !frames.empty()) {
+            frames.back().holdMs += ms; // two delays in a row
+            return;
+        }
+        frames.push_back(Frame(std::string(), ms));
+        frames.back().text.swap(current);
+    }
+
+    void Recorder::coalesce() {
+        if (frames.empty()) {
+            return;
+        }
+        std::string text;
+        for (const Frame& frame : frames) {
+            text += frame.text;
+        }
+        frames.clear();
+        current.insert(0, text);
+    }
+
+    void Recorder::take(std::deque<Frame>& into) {
+        for (Frame& frame : frames) {
+            into.push_back(Frame(std::string(), frame.holdMs));
+            into.back().text.swap(frame.text);
+        }
+        frames.clear();
+        if (!current.empty()) {
+            into.push_back(Frame(std::string(), 0));
+            into.back().text.swap(current);
+        }
+        bytes = 0;
+    }
+
+    void record(Recorder* recorder) {
+        recording = recorder;
+    }
+
+    void hold(int ms) {
+        if (recording) {
+            recording->hold(ms);
+        }
+    }
+
+    void coalesce(std::deque<Frame>& frames) {
+        if (frames.size() < 2 && (frames.empty() || frames.front().holdMs == 0)) {
+            return;
+        }
+        std::string text;
+        for (const Frame& frame : frames) {
+            text += frame.text;
+        }
+        frames.clear();
+        frames.push_back(Frame(std::string(), 0));
+        frames.back().text.swap(text);
+    }
+
+    void play(std::deque<Frame>& frames, std::ostream& out, const std::function<bool(int)>& waitForInput,
+              const std::function<void()>& shown) {
+        // Input typed ahead of the animation ends the first hold at once
+        bool skipping = false;
+        bool first = true;
+        while (!frames.empty()) {
+            Frame& frame = frames.front();
+            out << frame.text;
+            if (!skipping && frame.holdMs > 0) {
+                out.flush();
+                if (first && shown) {
+                    shown();
+                }
+                first = false;
+                skipping = waitForInput(frame.holdMs);
+            }
+            frames.pop_front();
+        }
+        out.flush();
+        if (first && shown) {
+            shown();
+        }
+    }
+}
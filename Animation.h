@@ -0,0 +1,65 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <string>
+#include <deque>
+#include <ostream>
+#include <streambuf>
+#include <functional>
+
+// Animations as timed frames instead of sleeps. A thread that records
+// sends its output to a Recorder, and Colors::delay() ends the current
+// frame with that hold time and returns at once. Whoever owns the screen
+// (Game::run, or the server loop for a socket) shows the frames on its own
+// clock and stops holding as soon as the player types, so an animation
+// never ties up a thread or holds back a command that is already waiting.
+namespace Animation {
+    struct Frame {
+        std::string text;
+        int holdMs;   // pause after showing the text
+
+        Frame(const std::string& frameText, int hold) : text(frameText), holdMs(hold) {}
+    };
+
+    class Recorder : public std::streambuf {
+    private:
+        std::deque<Frame> frames;
+        std::string current;   // text of the frame being written
+        size_t bytes;
+
+    protected:
+        int overflow(int c) override;
+        std::streamsize xsputn(const char* data, std::streamsize count) override;
+
+    public:
+        Recorder() : bytes(0) {}
+
+        // End the current frame, to be held for ms
+        void hold(int ms);
+        // Drop the holds recorded so far: input came in before they were shown
+        void coalesce();
+        // Move everything recorded to the back of `into`; the text after
+        // the last hold becomes a frame with no hold
+        void take(std::deque<Frame>& into);
+        size_t size() const { return bytes; }
+        bool empty() const { return bytes == 0 && frames.empty(); }
+    };
+
+    // Where this thread's delays go while it records (nullptr: nowhere)
+    void record(Recorder* recorder);
+    // Called by Colors::delay(); nothing happens unless the thread records
+    void hold(int ms);
+
+    // Drop the holds and join the text: how a queue of frames is shown
+    // once input has arrived
+    void coalesce(std::deque<Frame>& frames);
+
+    // Write the frames in order, flushing and holding after each.
+    // waitForInput(ms) returns true if input arrives within ms; from then
+    // on the remaining frames are written at once. `shown`, if given, is
+    // called once the first frame has been flushed.
+    void play(std::deque<Frame>& frames, std::ostream& out, const std::function<bool(int)>& waitForInput,
+              const std::function<void()>& shown = nullptr);
+}
+
+#endif
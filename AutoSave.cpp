@@ -0,0 +1,341 @@
+#include "AutoSave.h"
+#include "SaveFormat.h"
+#include "SaveStore.h"
+#include "Trace.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Journal record: u32 payload length, u32 CRC-32, payload (a save image
+// holding only the sections that changed since the previous record)
+static const size_t RECORD_HEADER_SIZE = 8;
+
+static void putU32(char* out, uint32_t value) {
+    out[0] = static_cast<char>(value & 0xFF);
+    out[1] = static_cast<char>((value >> 8) & 0xFF);
+    out[2] = static_cast<char>((value >> 16) & 0xFF);
+    out[3] = static_cast<char>((value >> 24) & 0xFF);
+}
+
+static uint32_t getU32(const char* in) {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(in);
+    return static_cast<uint32_t>(b[0]) | static_cast<uint32_t>(b[1]) << 8 |
+           static_cast<uint32_t>(b[2]) << 16 | static_cast<uint32_t>(b[3]) << 24;
+}
+
+static bool writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = ::write(fd, data, length);
+        if (written < 0) return false;
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+static uint64_t sectionId(uint32_t tag, uint32_t key) {
+    return static_cast<uint64_t>(tag) << 32 | key;
+}
+
+static std::string buildImage(const std::map<uint64_t, std::string>& sections) {
+    SaveFormat::Writer writer;
+    for (const auto& section : sections) {
+        writer.beginSection(static_cast<uint32_t>(section.first >> 32),
+                            static_cast<uint32_t>(section.first & 0xFFFFFFFFu));
+        writer.putBytes(section.second.data(), section.second.size());
+        writer.endSection();
+    }
+    return writer.finish();
+}
+
+// Overlay every section of a save image onto the map
+static bool mergeImage(const char* data, size_t size, std::map<uint64_t, std::string>& sections) {
+    SaveFormat::SaveFile image;
+    if (!image.parseBuffer(data, size)) {
+        return false;
+    }
+    for (const auto& section : image.getSections()) {
+        sections[sectionId(section.tag, section.key)] = section.payload.str();
+    }
+    return true;
+}
+
+static std::string readWholeFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Replay the intact prefix of a journal and return its length; a torn
+// final record (crash mid-append) is ignored
+static size_t replayJournal(const std::string& journal, std::map<uint64_t, std::string>& sections) {
+    size_t offset = 0;
+    while (journal.size() - offset >= RECORD_HEADER_SIZE) {
+        uint32_t length = getU32(journal.data() + offset);
+        uint32_t crc = getU32(journal.data() + offset + 4);
+        const char* payload = journal.data() + offset + RECORD_HEADER_SIZE;
+        if (journal.size() - offset - RECORD_HEADER_SIZE < length ||
+            SaveFormat::crc32(payload, length) != crc ||
+            !mergeImage(payload, length, sections)) {
+            break;
+        }
+        offset += RECORD_HEADER_SIZE + length;
+    }
+    return offset;
+}
+
+// Snapshot image (may be empty) plus the intact journal prefix
+static bool rebuild(const std::string& base, const std::string& journal, std::string& image) {
+    std::map<uint64_t, std::string> sections;
+    if (!base.empty() && !mergeImage(base.data(), base.size(), sections)) {
+        std::cerr << "Warning: saved snapshot is damaged, using journal only\n";
+        sections.clear();
+    }
+    replayJournal(readWholeFile(journal), sections);
+    if (sections.empty()) {
+        return false;
+    }
+    image = buildImage(sections);
+    return true;
+}
+
+// The thread that writes out every AutoSave in the process. Its mutex also
+// guards each AutoSave's fields shared with it.
+class AutoSave::Writer {
+private:
+    std::condition_variable wake;
+    std::deque<AutoSave*> ready;  // in the order their work arrived
+    bool stopping;
+    std::thread thread;
+
+    void loop();
+
+public:
+    std::mutex mutex;
+
+    // Started once every member, the mutex included, exists
+    Writer() : stopping(false) {
+        thread = std::thread(&Writer::loop, this);
+    }
+    ~Writer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        thread.join();
+    }
+
+    static Writer& instance() {
+        static Writer writer;
+        return writer;
+    }
+
+    // Queue a save that has work pending, unless it is already queued or
+    // being written (it is queued again once done); the mutex must be held
+    void schedule(AutoSave& save) {
+        if (!save.queued && !save.busy) {
+            save.queued = true;
+            ready.push_back(&save);
+            wake.notify_one();
+        }
+    }
+};
+
+void AutoSave::Writer::loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !ready.empty(); });
+        if (ready.empty()) {
+            break;
+        }
+
+        // Images may be partial (only dirty sections), so apply all of them
+        AutoSave& save = *ready.front();
+        ready.pop_front();
+        std::deque<std::string> images;
+        images.swap(save.pending);
+        bool compactNow = save.compactRequested;
+        save.compactRequested = false;
+        save.queued = false;
+        save.busy = true;
+        lock.unlock();
+
+        save.writeOut(images, compactNow);
+
+        lock.lock();
+        save.busy = false;
+        // Work that arrived meanwhile waits behind the other profiles
+        if (!save.pending.empty() || save.compactRequested) {
+            schedule(save);
+        }
+        save.workDone.notify_all();
+    }
+}
+
+AutoSave::AutoSave(SaveStore& saveStore, const std::string& profileName, const std::string& journal,
+                   int turnsBetweenSaves, int recordsBeforeCompaction)
+    : store(saveStore), profile(profileName), journalPath(journal),
+      turnsPerSave(std::max(1, turnsBetweenSaves)),
+      recordsPerCompaction(std::max(1, recordsBeforeCompaction)), turnCounter(0),
+      writer(Writer::instance()), compactRequested(false), queued(false), busy(false),
+      journalFd(-1), recordsSinceCompaction(0) {
+    // Start from whatever is already durable so the first delta is small
+    std::string image;
+    if (recover(store, profile, journalPath, image)) {
+        mergeImage(image.data(), image.size(), journaled);
+    }
+    journalFd = ::open(journalPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (journalFd < 0) {
+        std::cerr << "Warning: autosave journal unavailable at " << journalPath << "\n";
+    } else {
+        // Cut off a torn tail so new records aren't appended behind it
+        std::map<uint64_t, std::string> scratch;
+        size_t intact = replayJournal(readWholeFile(journalPath), scratch);
+        if (ftruncate(journalFd, static_cast<off_t>(intact)) != 0) {
+            std::cerr << "Warning: could not repair autosave journal\n";
+        }
+    }
+}
+
+AutoSave::~AutoSave() {
+    {
+        // Let the writer finish whatever is queued for this profile
+        std::unique_lock<std::mutex> lock(writer.mutex);
+        workDone.wait(lock, [this] { return !queued && !busy; });
+    }
+    if (journalFd >= 0) {
+        // Nothing left to replay after a final compaction
+        if (lseek(journalFd, 0, SEEK_END) == 0) {
+            ::unlink(journalPath.c_str());
+        }
+        ::close(journalFd);
+    }
+}
+
+bool AutoSave::onTurn() {
+    return ++turnCounter % turnsPerSave == 0;
+}
+
+void AutoSave::submit(std::string image) {
+    std::lock_guard<std::mutex> lock(writer.mutex);
+    pending.push_back(std::move(image));
+    writer.schedule(*this);
+}
+
+void AutoSave::submitSnapshot(std::string image) {
+    std::lock_guard<std::mutex> lock(writer.mutex);
+    pending.push_back(std::move(image));
+    compactRequested = true;
+    writer.schedule(*this);
+}
+
+void AutoSave::writeOut(const std::deque<std::string>& images, bool compactNow) {
+    for (const auto& image : images) {
+        appendDelta(image);
+    }
+    if (compactNow || recordsSinceCompaction >= recordsPerCompaction) {
+        compact();
+    }
+}
+
+void AutoSave::appendDelta(const std::string& image) {
+    Trace::Span span("AutoSave::appendDelta");
+    std::map<uint64_t, std::string> incoming;
+    if (!mergeImage(image.data(), image.size(), incoming)) {
+        return;
+    }
+    // Sections of a failed record go out again: the game does not resend
+    // them (map chunks are only sent while dirty)
+    incoming.insert(unwritten.begin(), unwritten.end());
+    unwritten.clear();
+
+    // Keep only the sections whose bytes changed since the last record
+    std::map<uint64_t, std::string> changed;
+    for (auto& section : incoming) {
+        auto it = journaled.find(section.first);
+        if (it == journaled.end() || it->second != section.second) {
+            changed[section.first].swap(section.second);
+        }
+    }
+    if (changed.empty()) {
+        return;
+    }
+
+    // `journaled` only takes what is durable; a failed record is kept in
+    // `unwritten` and written with the next delta or compaction. Without a
+    // journal the changes reach disk only through compaction, which saves
+    // `journaled`.
+    if (journalFd >= 0) {
+        std::string payload = buildImage(changed);
+        char header[RECORD_HEADER_SIZE];
+        putU32(header, static_cast<uint32_t>(payload.size()));
+        putU32(header + 4, SaveFormat::crc32(payload.data(), payload.size()));
+        off_t end = lseek(journalFd, 0, SEEK_END);
+        if (!writeAll(journalFd, header, RECORD_HEADER_SIZE) ||
+            !writeAll(journalFd, payload.data(), payload.size()) || fsync(journalFd) != 0) {
+            std::cerr << "Warning: autosave journal write failed\n";
+            // Cut off the partial record so later ones are not stranded behind it
+            if (end >= 0 && ftruncate(journalFd, end) != 0) {
+                std::cerr << "Warning: could not repair autosave journal\n";
+            }
+            unwritten.swap(changed);
+            return;
+        }
+        recordsSinceCompaction++;
+    }
+    for (auto& section : changed) {
+        journaled[section.first].swap(section.second);
+    }
+}
+
+void AutoSave::compact() {
+    Trace::Span span("AutoSave::compact");
+    // Sections no journal record holds yet go into the snapshot as well
+    std::map<uint64_t, std::string> merged;
+    if (!unwritten.empty()) {
+        merged = journaled;
+        for (const auto& section : unwritten) {
+            merged[section.first] = section.second;
+        }
+    }
+    const std::map<uint64_t, std::string>& sections = unwritten.empty() ? journaled : merged;
+    if (sections.empty()) {
+        return;
+    }
+
+    // The store keeps the previous record until the new one is durable
+    if (!store.put(profile, buildImage(sections))) {
+        std::cerr << "Warning: autosave compaction failed: " << store.getError() << "\n";
+        return;
+    }
+    if (!unwritten.empty()) {
+        journaled.swap(merged);
+        unwritten.clear();
+    }
+
+    // The snapshot now holds everything the journal did
+    if (journalFd >= 0 && ftruncate(journalFd, 0) == 0) {
+        fsync(journalFd);
+    }
+    recordsSinceCompaction = 0;
+}
+
+bool AutoSave::recover(const SaveStore& saveStore, const std::string& profileName,
+                       const std::string& journal, std::string& image) {
+    std::string base;
+    if (saveStore.contains(profileName) && !saveStore.get(profileName, base)) {
+        std::cerr << "Warning: stored save for " << profileName << " is damaged\n";
+        base.clear();
+    }
+    return rebuild(base, journal, image);
+}
+
+bool AutoSave::recover(const std::string& snapshot, std::string& image) {
+    return rebuild(readWholeFile(snapshot), snapshot + ".journal", image);
+}
@@ -0,0 +1,80 @@
+#ifndef AUTOSAVE_H
+#define AUTOSAVE_H
+
+#include <string>
+#include <map>
+#include <deque>
+#include <condition_variable>
+#include <cstdint>
+
+class SaveStore;
+
+// Crash-safe background saving for one profile.
+//
+// The game thread hands over a serialized save image every few turns; the
+// writer thread diffs it against the last journaled state and appends only
+// the changed sections to the profile's journal file (length + CRC framed).
+// After enough records the journal is compacted: the merged state is put
+// into the SaveStore, which replaces the record copy-on-write, then the
+// journal is truncated. A crash at any point leaves either the old or the
+// new snapshot plus a journal whose intact prefix can be replayed.
+//
+// One writer thread serves every AutoSave in the process, taking the
+// profiles with work queued in turn, so a server runs one thread and one
+// fsync at a time however many sessions it has. Each profile must have at
+// most one AutoSave open.
+class AutoSave {
+private:
+    class Writer;
+
+    SaveStore& store;
+    std::string profile;
+    std::string journalPath;
+    int turnsPerSave;
+    int recordsPerCompaction;
+    int turnCounter;
+    Writer& writer;
+
+    // Shared with the writer, under its mutex
+    std::condition_variable workDone;
+    std::deque<std::string> pending;
+    bool compactRequested;
+    bool queued;  // waiting in the writer's queue
+    bool busy;    // being written out
+
+    // Writer-only state
+    std::map<uint64_t, std::string> journaled; // latest bytes per (tag, key)
+    std::map<uint64_t, std::string> unwritten; // sections of a failed record
+    int journalFd;
+    int recordsSinceCompaction;
+
+    void writeOut(const std::deque<std::string>& images, bool compactNow);
+    void appendDelta(const std::string& image);
+    void compact();
+
+public:
+    AutoSave(SaveStore& saveStore, const std::string& profileName, const std::string& journal,
+             int turnsBetweenSaves = 5, int recordsBeforeCompaction = 20);
+    ~AutoSave();
+    AutoSave(const AutoSave&) = delete;
+    AutoSave& operator=(const AutoSave&) = delete;
+
+    // Called once per game turn; true every N turns, when the caller
+    // should submit() a fresh image
+    bool onTurn();
+    // Queue a save image. Sections omitted from it keep their last saved
+    // contents, so callers only need to include what changed.
+    void submit(std::string image);
+    // Queue an image and compact everything into the snapshot. Returns at
+    // once like submit(); the destructor waits until it is durable.
+    void submitSnapshot(std::string image);
+
+    // Rebuild the latest state of a profile from its stored snapshot plus
+    // journal into a save image
+    static bool recover(const SaveStore& saveStore, const std::string& profileName,
+                        const std::string& journal, std::string& image);
+    // Same for a single-file save from an older version ("<snapshot>.journal")
+    static bool recover(const std::string& snapshot, std::string& image);
+};
+
+#endif
@@ -1,184 +1,202 @@
 #include "Battle.h"
 #include "Colors.h"
+#include "Console.h"
+#include "CommandSource.h"
+#include "Trace.h"
+#include "Ui.h"
 #include <iostream>
 #include <cstdlib>
-#include <ctime>
 #include <string>
-#include <iomanip>
 
-Battle::Battle(Player* p, Enemy* e) : player(p), enemy(e), playerTurn(true) {
-    srand(time(nullptr));
+Battle::Battle(Player* p, Enemy* e) : player(p), enemy(e), prompt(Prompt::ACTION), won(false) {
 }
 
-bool Battle::start() {
-    std::cout << "\n" << Colors::BRIGHT_RED;
-    std::cout << "╔════════════════════════════════════════════════════════════╗\n";
-    std::cout << "║                    ⚔️  BATTLE BEGINS! ⚔️                    ║\n";
-    std::cout << "╚════════════════════════════════════════════════════════════╝\n" << Colors::RESET;
+void Battle::begin() {
+    Trace::Span span("Battle::begin");
+    static const Ui::Template banner(std::string("\n") + Colors::BRIGHT_RED +
+        "╔════════════════════════════════════════════════════════════╗\n"
+        "║" + Ui::center("⚔️ BATTLE BEGINS! ⚔️", 60).str() + "║\n"
+        "╚════════════════════════════════════════════════════════════╝\n" + Colors::RESET);
+    banner.render(Console::out());
     
     // Animated enemy entrance
     Colors::typewriter("👹 A wild ", 30);
-    std::cout << Colors::BRIGHT_RED << enemy->getName() << Colors::RESET;
+    Console::out() << Colors::BRIGHT_RED << enemy->getName() << Colors::RESET;
     Colors::typewriter(" appears!\n\n", 30);
     Colors::delay(500);
     
-    while (player->getHealth() > 0 && enemy->isAlive()) {
-        displayBattleStatus();
-        
-        if (playerTurn) {
-            playerAction();
-            playerTurn = false;
-        } else {
-            enemyAction();
-            playerTurn = true;
-        }
-        
-        // Check if battle is over
-        if (!enemy->isAlive()) {
-            Colors::delay(300);
-            std::cout << "\n" << Colors::BRIGHT_GREEN;
-            std::cout << "╔════════════════════════════════════════════════════════════╗\n";
-            std::cout << "║                    🏆 VICTORY! 🏆                          ║\n";
-            std::cout << "╚════════════════════════════════════════════════════════════╝\n" << Colors::RESET;
-            
-            Colors::typewriter("✅ You defeated the ", 25);
-            std::cout << Colors::BRIGHT_YELLOW << enemy->getName() << Colors::RESET;
-            Colors::typewriter("!\n", 25);
-            
-            Colors::delay(200);
-            std::cout << Colors::BRIGHT_CYAN << "✨ You gained " << Colors::YELLOW << enemy->getExperienceReward() << Colors::BRIGHT_CYAN << " experience!\n";
-            Colors::delay(200);
-            std::cout << "💰 You found " << Colors::YELLOW << enemy->getGoldReward() << Colors::BRIGHT_CYAN << " gold!\n" << Colors::RESET;
-            
-            player->gainExperience(enemy->getExperienceReward());
-            player->addGold(enemy->getGoldReward());
-            
-            return true;
-        }
-        
-        if (player->getHealth() <= 0) {
-            Colors::delay(300);
-            std::cout << "\n" << Colors::BRIGHT_RED;
-            std::cout << "╔════════════════════════════════════════════════════════════╗\n";
-            std::cout << "║                    💀 DEFEAT 💀                            ║\n";
-            std::cout << "╚════════════════════════════════════════════════════════════╝\n" << Colors::RESET;
-            Colors::typewriter("❌ You have been defeated...\n", 40);
-            return false;
-        }
-    }
-    
-    return false;
+    displayBattleStatus();
+    showActionMenu();
 }
 
-void Battle::playerAction() {
-    bool actionTaken = false;
-    while (!actionTaken) {
-        // Combat Menu
-        const int width = 50;
-        std::string border;
-        for (int i = 0; i < width - 2; ++i) border += "─";
-        
-        std::cout << "\n" << Colors::BRIGHT_GREEN;
-        std::cout << "┌" << border << "┐\n";
-        
-        std::string title = " YOUR TURN ";
-        int pad = (width - 2 - title.length()) / 2;
-        std::cout << "│" << std::string(pad, ' ') << Colors::BOLD << title << Colors::RESET << Colors::BRIGHT_GREEN << std::string(width - 2 - pad - title.length(), ' ') << "│\n";
-        std::cout << "├" << border << "┤\n";
-        
-        std::cout << "│  " << Colors::CYAN << "1. " << Colors::Emoji::ATTACK << " " << std::left << std::setw(width - 9) << "Attack" << Colors::BRIGHT_GREEN << "│\n";
-        std::cout << "│  " << Colors::CYAN << "2. " << Colors::Emoji::SCROLL << " " << std::left << std::setw(width - 9) << "Skills" << Colors::BRIGHT_GREEN << "│\n";
-        std::cout << "│  " << Colors::CYAN << "3. " << Colors::Emoji::DEFEND << " " << std::left << std::setw(width - 9) << "Defend" << Colors::BRIGHT_GREEN << "│\n";
-        std::cout << "│  " << Colors::CYAN << "4. " << Colors::Emoji::POTION << " " << std::left << std::setw(width - 9) << "Use Item" << Colors::BRIGHT_GREEN << "│\n";
-        
-        std::cout << "└" << border << "┘\n" << Colors::RESET;
-        std::cout << Colors::BRIGHT_YELLOW << "🎮 Choice: " << Colors::RESET;
-        
-        int choice;
-        if (!(std::cin >> choice)) {
-            std::cin.clear();
-            std::cin.ignore(10000, '\n');
-            choice = 0;
-        }
-        
-        switch(choice) {
-            case 1: { // Attack
-                int damage = player->attack();
-                // Attack animation
-                Colors::animateAttack(player->getName(), enemy->getName(), damage);
-                enemy->takeDamage(damage);
-                actionTaken = true;
-                break;
-            }
-            case 2: { // Skills
-                const auto& skills = player->getSkills();
-                if (skills.empty()) {
-                    std::cout << Colors::GRAY << "You have no skills learned!\n" << Colors::RESET;
+void Battle::showActionMenu() {
+    // Combat Menu
+    static const Ui::Template menu(std::string("\n") + Colors::BRIGHT_GREEN +
+        "┌────────────────────────────────────────────────┐\n"
+        "│" + Ui::center(std::string(Colors::BOLD) + " YOUR TURN " + Colors::RESET + Colors::BRIGHT_GREEN, 48).str() + "│\n"
+        "├────────────────────────────────────────────────┤\n"
+        "│  " + Colors::CYAN + "1. " + Colors::Emoji::ATTACK + " Attack" + Colors::BRIGHT_GREEN + "{@49}│\n" +
+        "│  " + Colors::CYAN + "2. " + Colors::Emoji::SCROLL + " Skills" + Colors::BRIGHT_GREEN + "{@49}│\n" +
+        "│  " + Colors::CYAN + "3. " + Colors::Emoji::DEFEND + " Defend" + Colors::BRIGHT_GREEN + "{@49}│\n" +
+        "│  " + Colors::CYAN + "4. " + Colors::Emoji::POTION + " Use Item" + Colors::BRIGHT_GREEN + "{@49}│\n" +
+        "└────────────────────────────────────────────────┘\n" + Colors::RESET +
+        Colors::BRIGHT_YELLOW + "🎮 Choice: " + Colors::RESET);
+    menu.render(Console::out());
+    prompt = Prompt::ACTION;
+}
+
+void Battle::feed(const std::string& line) {
+    Trace::Span span("Battle::turn");
+    switch (prompt) {
+        case Prompt::ACTION: {
+            switch (CommandSource::parseNumber(line, 0)) {
+                case 1: { // Attack
+                    int damage = player->attack();
+                    // Attack animation
+                    Colors::animateAttack(player->getName(), enemy->getName(), damage);
+                    enemy->takeDamage(damage);
+                    playerActionDone();
                     break;
                 }
-                
-                std::cout << "\n" << Colors::BRIGHT_MAGENTA << "✨ SKILLS ✨\n" << Colors::RESET;
-                for (size_t i = 0; i < skills.size(); ++i) {
-                     std::cout << Colors::CYAN << (i + 1) << ". " << Colors::WHITE << skills[i].name 
-                               << Colors::BLUE << " (" << skills[i].manaCost << " MP)" 
-                               << Colors::GRAY << " - " << skills[i].description << "\n";
+                case 2: { // Skills
+                    const auto& skills = player->getSkills();
+                    if (skills.empty()) {
+                        Console::out() << Colors::GRAY << "You have no skills learned!\n" << Colors::RESET;
+                        showActionMenu();
+                        break;
+                    }
+                    
+                    Console::out() << "\n" << Colors::BRIGHT_MAGENTA << "✨ SKILLS ✨\n" << Colors::RESET;
+                    for (size_t i = 0; i < skills.size(); ++i) {
+                         Console::out() << Colors::CYAN << (i + 1) << ". " << Colors::WHITE << skills[i].name 
+                                   << Colors::BLUE << " (" << skills[i].manaCost << " MP)" 
+                                   << Colors::GRAY << " - " << skills[i].description << "\n";
+                    }
+                    Console::out() << Colors::GRAY << "0. Cancel\n" << Colors::RESET;
+                    Console::out() << Colors::BRIGHT_YELLOW << "Select skill: " << Colors::RESET;
+                    prompt = Prompt::SKILL;
+                    break;
                 }
-                std::cout << Colors::GRAY << "0. Cancel\n" << Colors::RESET;
-                std::cout << Colors::BRIGHT_YELLOW << "Select skill: " << Colors::RESET;
-                
-                int skillChoice;
-                if (!(std::cin >> skillChoice)) {
-                     std::cin.clear(); std::cin.ignore(10000, '\n'); 
-                     skillChoice = -1;
+                case 3: { // Defend
+                    Console::out() << Colors::BRIGHT_BLUE << Colors::Emoji::DEFEND << " You take a defensive stance!\n" << Colors::RESET;
+                    // Defense logic placeholder
+                    playerActionDone();
+                    break;
                 }
-                
-                if (skillChoice == 0) break; // Back to main menu
-                
-                auto result = player->castSkill(skillChoice - 1);
-                if (result.first == -1) {
-                    std::cout << Colors::BRIGHT_RED << "❌ Not enough Mana!\n" << Colors::RESET;
-                } else if (result.first == -2) {
-                     std::cout << Colors::BRIGHT_RED << "❌ Invalid skill selection.\n" << Colors::RESET;
-                } else {
-                    // Success
-                    if (result.second == "heal") {
-                         std::cout << Colors::BRIGHT_GREEN << "✨ You cast " << skills[skillChoice-1].name 
-                                   << " and healed " << Colors::GREEN << result.first << Colors::BRIGHT_GREEN << " HP!\n" << Colors::RESET;
-                    } else {
-                         std::cout << Colors::BRIGHT_MAGENTA << "⚡ You cast " << skills[skillChoice-1].name 
-                                   << " dealing " << Colors::BRIGHT_RED << result.first << Colors::BRIGHT_MAGENTA << " damage!\n" << Colors::RESET;
-                         enemy->takeDamage(result.first);
-                    }
-                    actionTaken = true;
+                case 4: { // Item
+                    player->displayInventory();
+                    Console::out() << Colors::BRIGHT_YELLOW << "Enter item name to use (or 'cancel'): " << Colors::RESET;
+                    prompt = Prompt::ITEM;
+                    break;
                 }
-                break;
+                default:
+                    Console::out() << Colors::BRIGHT_RED << "❌ Invalid choice. Try again.\n" << Colors::RESET;
+                    showActionMenu();
             }
-            case 3: { // Defend
-                std::cout << Colors::BRIGHT_BLUE << Colors::Emoji::DEFEND << " You take a defensive stance!\n" << Colors::RESET;
-                // Defense logic placeholder
-                actionTaken = true;
+            break;
+        }
+        case Prompt::SKILL: {
+            int skillChoice = CommandSource::parseNumber(line, -1);
+            if (skillChoice == 0) { // Back to main menu
+                showActionMenu();
                 break;
             }
-            case 4: { // Item
-                player->displayInventory();
-                std::cout << Colors::BRIGHT_YELLOW << "Enter item name to use (or 'cancel'): " << Colors::RESET;
-                std::string itemName;
-                std::cin.ignore(); 
-                std::getline(std::cin, itemName);
-                if (itemName != "cancel") {
-                    player->useItem(itemName);
-                    actionTaken = true;
+            
+            const auto& skills = player->getSkills();
+            auto result = player->castSkill(skillChoice - 1);
+            if (result.first == -1) {
+                Console::out() << Colors::BRIGHT_RED << "❌ Not enough Mana!\n" << Colors::RESET;
+                showActionMenu();
+            } else if (result.first == -2) {
+                Console::out() << Colors::BRIGHT_RED << "❌ Invalid skill selection.\n" << Colors::RESET;
+                showActionMenu();
+            } else {
+                // Success
+                if (result.second == "heal") {
+                     Console::out() << Colors::BRIGHT_GREEN << "✨ You cast " << skills[skillChoice-1].name 
+                               << " and healed " << Colors::GREEN << result.first << Colors::BRIGHT_GREEN << " HP!\n" << Colors::RESET;
+                } else {
+                     Console::out() << Colors::BRIGHT_MAGENTA << "⚡ You cast " << skills[skillChoice-1].name 
+                               << " dealing " << Colors::BRIGHT_RED << result.first << Colors::BRIGHT_MAGENTA << " damage!\n" << Colors::RESET;
+                     enemy->takeDamage(result.first);
                 }
-                break;
+                playerActionDone();
+            }
+            break;
+        }
+        case Prompt::ITEM: {
+            if (!line.empty() && line != "cancel") {
+                player->useItem(line);
+                playerActionDone();
+            } else {
+                showActionMenu();
             }
-            default:
-                std::cout << Colors::BRIGHT_RED << "❌ Invalid choice. Try again.\n" << Colors::RESET;
+            break;
         }
+        case Prompt::OVER:
+            break;
+    }
+}
+
+void Battle::endOfInput() {
+    while (!isOver()) {
+        if (prompt != Prompt::ACTION) {
+            showActionMenu();
+        }
+        feed("1");
+    }
+}
+
+// The enemy answers unless the player's action ended the battle
+void Battle::playerActionDone() {
+    if (!enemy->isAlive()) {
+        finish(true);
+        return;
+    }
+    displayBattleStatus();
+    enemyAction();
+    if (player->getHealth() <= 0) {
+        finish(false);
+        return;
+    }
+    displayBattleStatus();
+    showActionMenu();
+}
+
+void Battle::finish(bool playerWon) {
+    won = playerWon;
+    prompt = Prompt::OVER;
+    Colors::delay(300);
+    if (playerWon) {
+        static const Ui::Template victory(std::string("\n") + Colors::BRIGHT_GREEN +
+            "╔════════════════════════════════════════════════════════════╗\n"
+            "║" + Ui::center("🏆 VICTORY! 🏆", 60).str() + "║\n"
+            "╚════════════════════════════════════════════════════════════╝\n" + Colors::RESET);
+        victory.render(Console::out());
+        
+        Colors::typewriter("✅ You defeated the ", 25);
+        Console::out() << Colors::BRIGHT_YELLOW << enemy->getName() << Colors::RESET;
+        Colors::typewriter("!\n", 25);
+        
+        Colors::delay(200);
+        Console::out() << Colors::BRIGHT_CYAN << "✨ You gained " << Colors::YELLOW << enemy->getExperienceReward() << Colors::BRIGHT_CYAN << " experience!\n";
+        Colors::delay(200);
+        Console::out() << "💰 You found " << Colors::YELLOW << enemy->getGoldReward() << Colors::BRIGHT_CYAN << " gold!\n" << Colors::RESET;
+        
+        player->gainExperience(enemy->getExperienceReward());
+        player->addGold(enemy->getGoldReward());
+    } else {
+        static const Ui::Template defeat(std::string("\n") + Colors::BRIGHT_RED +
+            "╔════════════════════════════════════════════════════════════╗\n"
+            "║" + Ui::center("💀 DEFEAT 💀", 60).str() + "║\n"
+            "╚════════════════════════════════════════════════════════════╝\n" + Colors::RESET);
+        defeat.render(Console::out());
+        Colors::typewriter("❌ You have been defeated...\n", 40);
     }
 }
 
 void Battle::enemyAction() {
-    std::cout << "\n" << Colors::BRIGHT_RED << "── 👹 Enemy Turn ──\n" << Colors::RESET;
+    Console::out() << "\n" << Colors::BRIGHT_RED << "── 👹 Enemy Turn ──\n" << Colors::RESET;
     Colors::delay(400);
     int damage = enemy->attack();
     Colors::animateAttack(enemy->getName(), player->getName(), damage);
@@ -186,37 +204,36 @@ void Battle::enemyAction() {
 }
 
 void Battle::displayBattleStatus() const {
-    std::cout << "\n" << Colors::BRIGHT_RED;
-    std::cout << "╔══════════════════════════════════════════════════╗\n";
-    std::cout << "║               ⚔️  BATTLE ARENA  ⚔️                ║\n";
-    std::cout << "╠══════════════════════════════════════════════════╣\n" << Colors::RESET;
-    
-    // Player Stats
-    std::cout << Colors::BRIGHT_RED << "║ " << Colors::BRIGHT_GREEN << "🧑‍🎤 " << std::left << std::setw(44) << player->getName() << Colors::BRIGHT_RED << "║\n";
-    
-    // Build health bar string
-    std::string hpBar = Colors::healthBar(player->getHealth(), player->getMaxHealth(), 20);
-    std::string hpText = std::to_string(player->getHealth()) + "/" + std::to_string(player->getMaxHealth());
-    std::cout << Colors::BRIGHT_RED << "║ " << Colors::RED << "❤️  HP: " << hpBar 
-              << Colors::WHITE << " " << std::left << std::setw(8) << hpText << Colors::BRIGHT_RED << "  ║\n";
-    
-    std::string mpBar = Colors::manaBar(player->getMana(), player->getMaxMana(), 20);
-    std::string mpText = std::to_string(player->getMana()) + "/" + std::to_string(player->getMaxMana());
-    std::cout << Colors::BRIGHT_RED << "║ " << Colors::BLUE << "💙 MP: " << mpBar 
-              << Colors::WHITE << " " << std::left << std::setw(8) << mpText << Colors::BRIGHT_RED << "  ║\n";
-              
-    std::cout << Colors::BRIGHT_RED << "╠──────────────────────────────────────────────────╣\n";
-    std::cout << Colors::BRIGHT_RED << "║                     ⚡ VS ⚡                      ║\n";
-    std::cout << Colors::BRIGHT_RED << "╠──────────────────────────────────────────────────╣\n";
-    
-    // Enemy Stats
-    std::cout << Colors::BRIGHT_RED << "║ " << Colors::BRIGHT_MAGENTA << "👹 " << std::left << std::setw(44) << enemy->getName() << Colors::BRIGHT_RED << "║\n";
-    
-    std::string ehpBar = Colors::healthBar(enemy->getHealth(), enemy->getMaxHealth(), 20);
-    std::string ehpText = std::to_string(enemy->getHealth()) + "/" + std::to_string(enemy->getMaxHealth());
-    std::cout << Colors::BRIGHT_RED << "║ " << Colors::RED << "❤️  HP: " << ehpBar 
-              << Colors::WHITE << " " << std::left << std::setw(8) << ehpText << Colors::BRIGHT_RED << "  ║\n";
-              
-    std::cout << Colors::BRIGHT_RED << "╚══════════════════════════════════════════════════╝\n" << Colors::RESET;
+    Trace::Span span("Battle::displayBattleStatus");
+    static const Ui::Template status(std::string("\n") + Colors::BRIGHT_RED +
+        "╔══════════════════════════════════════════════════╗\n"
+        "║" + Ui::center("⚔️ BATTLE ARENA ⚔️", 50).str() + "║\n"
+        "╠══════════════════════════════════════════════════╣\n" + Colors::RESET +
+        // Player Stats
+        Colors::BRIGHT_RED + "║ " + Colors::BRIGHT_GREEN + "🧑‍🎤 {}" + Colors::BRIGHT_RED + "{@51}║\n" +
+        Colors::BRIGHT_RED + "║ " + Colors::RED + "❤️ HP: {}" + Colors::WHITE + " {}" + Colors::BRIGHT_RED + "{@51}║\n" +
+        Colors::BRIGHT_RED + "║ " + Colors::BLUE + "💙 MP: {}" + Colors::WHITE + " {}" + Colors::BRIGHT_RED + "{@51}║\n" +
+        Colors::BRIGHT_RED + "╠──────────────────────────────────────────────────╣\n" +
+        Colors::BRIGHT_RED + "║" + Ui::center("⚡ VS ⚡", 50).str() + "║\n" +
+        Colors::BRIGHT_RED + "╠──────────────────────────────────────────────────╣\n" +
+        // Enemy Stats
+        Colors::BRIGHT_RED + "║ " + Colors::BRIGHT_MAGENTA + "👹 {}" + Colors::BRIGHT_RED + "{@51}║\n" +
+        Colors::BRIGHT_RED + "║ " + Colors::RED + "❤️ HP: {}" + Colors::WHITE + " {}" + Colors::BRIGHT_RED + "{@51}║\n" +
+        Colors::BRIGHT_RED + "╚══════════════════════════════════════════════════╝\n" + Colors::RESET);
+
+    Ui::Text hpText;
+    hpText << player->getHealth() << '/' << player->getMaxHealth();
+    Ui::Text mpText;
+    mpText << player->getMana() << '/' << player->getMaxMana();
+    Ui::Text enemyHpText;
+    enemyHpText << enemy->getHealth() << '/' << enemy->getMaxHealth();
+    // Bars stream straight from the glyph table
+    status.render(Console::out(), {
+        player->getName(),
+        Colors::healthBarView(player->getHealth(), player->getMaxHealth(), 20), hpText,
+        Colors::manaBarView(player->getMana(), player->getMaxMana(), 20), mpText,
+        enemy->getName(),
+        Colors::healthBarView(enemy->getHealth(), enemy->getMaxHealth(), 20), enemyHpText
+    });
 }
 
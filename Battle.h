@@ -3,23 +3,44 @@
 
 #include "Player.h"
 #include "Enemy.h"
+#include <string>
 
+// A battle advances one line of input at a time: begin() shows the opening
+// and the first menu, then each feed() resolves the player's answer (and
+// the enemy's reply) and shows the next prompt, until isOver().
 class Battle {
+public:
+    enum class Prompt {
+        ACTION,   // 1-4 from the combat menu
+        SKILL,    // skill number, 0 to cancel
+        ITEM,     // item name, 'cancel' to go back
+        OVER
+    };
+
 private:
     Player* player;
     Enemy* enemy;
-    bool playerTurn;
-    
-    void playerAction();
+    Prompt prompt;
+    bool won;
+
+    void showActionMenu();
+    void playerActionDone();
     void enemyAction();
+    void finish(bool playerWon);
     void displayBattleStatus() const;
 
 public:
     Battle(Player* p, Enemy* e);
-    
-    // Returns true if player wins, false if player loses
-    bool start();
+
+    void begin();
+    void feed(const std::string& line);
+    // No more input: keep attacking so the battle still ends
+    void endOfInput();
+
+    Prompt getPrompt() const { return prompt; }
+    bool isOver() const { return prompt == Prompt::OVER; }
+    // Valid once isOver()
+    bool playerWon() const { return won; }
 };
 
 #endif
-
@@ -0,0 +1,124 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+int NullSink::overflow(int c) {
+    if (c != traits_type::eof()) {
+        bytes++;
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize NullSink::xsputn(const char*, std::streamsize count) {
+    bytes += static_cast<uint64_t>(count);
+    return count;
+}
+
+void Benchmark::add(const std::string& name, Operation operation, const NullSink* sink) {
+    Case benchCase;
+    benchCase.name = name;
+    benchCase.operation = operation;
+    benchCase.sink = sink;
+    cases.push_back(benchCase);
+}
+
+static double secondsFor(const Benchmark::Operation& operation, uint64_t count) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < count; i++) {
+        operation();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+Benchmark::Result Benchmark::measure(const Case& benchCase) {
+    // Grow the batch until one repetition is long enough to time
+    uint64_t batch = 1;
+    double target = options.targetMs / 1000.0;
+    while (true) {
+        double seconds = secondsFor(benchCase.operation, batch);
+        if (seconds >= target || batch >= (1ull << 30)) {
+            break;
+        }
+        batch = seconds < target / 100 ? batch * 10 : batch * 2;
+    }
+
+    for (int i = 0; i < options.warmup; i++) {
+        secondsFor(benchCase.operation, batch);
+    }
+
+    uint64_t bytesBefore = benchCase.sink ? benchCase.sink->getBytes() : 0;
+    std::vector<double> perOp;
+    for (int i = 0; i < options.repetitions; i++) {
+        perOp.push_back(secondsFor(benchCase.operation, batch) * 1e9 / batch);
+    }
+    uint64_t bytes = benchCase.sink ? benchCase.sink->getBytes() - bytesBefore : 0;
+
+    Result result;
+    result.name = benchCase.name;
+    result.operations = batch;
+    result.repetitions = options.repetitions;
+    std::sort(perOp.begin(), perOp.end());
+    result.minNs = perOp.front();
+    result.maxNs = perOp.back();
+    size_t middle = perOp.size() / 2;
+    result.medianNs = perOp.size() % 2 ? perOp[middle] : (perOp[middle - 1] + perOp[middle]) / 2;
+    double sum = 0;
+    for (double value : perOp) sum += value;
+    result.meanNs = sum / perOp.size();
+    double squares = 0;
+    for (double value : perOp) squares += (value - result.meanNs) * (value - result.meanNs);
+    result.stddevNs = perOp.size() > 1 ? std::sqrt(squares / (perOp.size() - 1)) : 0;
+    result.bytesPerOp = static_cast<double>(bytes) / (static_cast<double>(batch) * options.repetitions);
+    return result;
+}
+
+void Benchmark::run(std::ostream& progress) {
+    for (const Case& benchCase : cases) {
+        if (!options.filter.empty() && benchCase.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        results.push_back(measure(benchCase));
+        const Result& result = results.back();
+        progress << std::left << std::setw(40) << result.name << std::right << std::fixed
+                 << std::setprecision(1) << std::setw(12) << result.medianNs << " ns/op\n";
+    }
+}
+
+void Benchmark::writeTable(std::ostream& out) const {
+    out << std::left << std::setw(40) << "benchmark" << std::right
+        << std::setw(12) << "median ns" << std::setw(12) << "min ns" << std::setw(12) << "max ns"
+        << std::setw(10) << "stddev%" << std::setw(12) << "bytes/op" << "\n";
+    out << std::fixed << std::setprecision(1);
+    for (const Result& result : results) {
+        out << std::left << std::setw(40) << result.name << std::right
+            << std::setw(12) << result.medianNs << std::setw(12) << result.minNs
+            << std::setw(12) << result.maxNs
+            << std::setw(10) << (result.meanNs > 0 ? 100 * result.stddevNs / result.meanNs : 0)
+            << std::setw(12) << result.bytesPerOp << "\n";
+    }
+}
+
+bool Benchmark::writeJson(const std::string& filename) const {
+    std::ofstream file(filename.c_str(), std::ios::trunc);
+    if (!file) {
+        std::cerr << "Error: could not write " << filename << "\n";
+        return false;
+    }
+    file << std::fixed << std::setprecision(2);
+    file << "{\n  \"warmup\": " << options.warmup << ",\n  \"repetitions\": " << options.repetitions
+         << ",\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        file << (i ? ",\n" : "\n")
+             << "    {\"name\": \"" << result.name << "\", \"operations\": " << result.operations
+             << ", \"median_ns\": " << result.medianNs << ", \"mean_ns\": " << result.meanNs
+             << ", \"min_ns\": " << result.minNs << ", \"max_ns\": " << result.maxNs
+             << ", \"stddev_ns\": " << result.stddevNs << ", \"bytes_per_op\": " << result.bytesPerOp << "}";
+    }
+    file << "\n  ]\n}\n";
+    return static_cast<bool>(file);
+}
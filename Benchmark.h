@@ -0,0 +1,79 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+#include <streambuf>
+#include <cstdint>
+
+// Output that goes nowhere but is still fully formatted, so rendering code
+// does all its work; counts the bytes it was given.
+class NullSink : public std::streambuf {
+private:
+    uint64_t bytes;
+
+protected:
+    int overflow(int c) override;
+    std::streamsize xsputn(const char* data, std::streamsize count) override;
+
+public:
+    NullSink() : bytes(0) {}
+    uint64_t getBytes() const { return bytes; }
+    void reset() { bytes = 0; }
+};
+
+// A small micro-benchmark harness. Each case is a function that performs
+// one operation; the harness calibrates how many operations make up a
+// repetition of roughly `targetMs`, runs warmup repetitions, then times
+// `repetitions` of them and reports nanoseconds per operation.
+class Benchmark {
+public:
+    struct Options {
+        int warmup;          // repetitions run before timing
+        int repetitions;     // timed repetitions
+        double targetMs;     // aim for repetitions about this long
+        std::string filter;  // run only cases whose name contains this
+
+        Options() : warmup(2), repetitions(15), targetMs(20.0) {}
+    };
+
+    struct Result {
+        std::string name;
+        uint64_t operations;     // per repetition
+        int repetitions;
+        double minNs, medianNs, meanNs, stddevNs, maxNs; // per operation
+        double bytesPerOp;       // output written to the case's sink, if any
+    };
+
+    typedef std::function<void()> Operation;
+
+private:
+    struct Case {
+        std::string name;
+        Operation operation;
+        const NullSink* sink;
+    };
+
+    Options options;
+    std::vector<Case> cases;
+    std::vector<Result> results;
+
+    Result measure(const Case& benchCase);
+
+public:
+    explicit Benchmark(const Options& benchOptions) : options(benchOptions) {}
+
+    // Register a case; pass the sink its output goes to for bytes/op
+    void add(const std::string& name, Operation operation, const NullSink* sink = nullptr);
+
+    // Run every case that matches the filter, printing a line for each
+    void run(std::ostream& progress);
+
+    const std::vector<Result>& getResults() const { return results; }
+    void writeTable(std::ostream& out) const;
+    bool writeJson(const std::string& filename) const;
+};
+
+#endif
@@ -1,95 +1,133 @@
 #include "Colors.h"
+#include "Console.h"
+#include "Animation.h"
+#include "Ui.h"
 #include <iostream>
-#include <sstream>
 #include <vector>
-#include <thread>
-#include <chrono>
-#include <iomanip>
+#include <algorithm>
 
 namespace Colors {
     
-    // Helper function for delays
+    // Per thread, so server sessions and a local game don't interfere
+    static thread_local bool animationsOn = true;
+    
+    void setAnimationsEnabled(bool enabled) {
+        animationsOn = enabled;
+    }
+    
+    bool animationsEnabled() {
+        return animationsOn;
+    }
+    
+    // Delays never sleep: they end a frame of the thread's recording, and
+    // whoever shows the frames does the waiting (see Animation.h)
     void delay(int milliseconds) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+        if (animationsOn) {
+            Animation::hold(milliseconds);
+        }
     }
     
     std::string colorize(const std::string& text, const char* color) {
         return std::string(color) + text + RESET;
     }
     
-    std::string healthBar(int current, int max, int width) {
+    // MAX_BAR_WIDTH full blocks followed by as many light ones. Every bar
+    // is one slice of it: `filled` full blocks run into the light ones.
+    static const size_t GLYPH_BYTES = 3; // "█" and "░" are both 3 bytes
+    
+    static const std::string& barGlyphs() {
+        static const std::string table = [] {
+            std::string glyphs;
+            glyphs.reserve(2 * MAX_BAR_WIDTH * GLYPH_BYTES);
+            for (int i = 0; i < MAX_BAR_WIDTH; i++) glyphs += "█";
+            for (int i = 0; i < MAX_BAR_WIDTH; i++) glyphs += "░";
+            return glyphs;
+        }();
+        return table;
+    }
+    
+    static Bar barView(const char* color, int current, int max, int width) {
+        width = (width < 0) ? 0 : (width > MAX_BAR_WIDTH) ? MAX_BAR_WIDTH : width;
         if (max <= 0) max = 1;
         int filled = (current * width) / max;
         filled = (filled < 0) ? 0 : (filled > width) ? width : filled;
         
-        std::stringstream ss;
-        ss << Colors::RED << "[";
-        
-        // Filled portion in red
-        for (int i = 0; i < filled; i++) {
-            ss << "█";
-        }
-        
-        // Empty portion
-        for (int i = filled; i < width; i++) {
-            ss << "░";
-        }
-        
-        ss << "]" << Colors::RESET;
-        return ss.str();
+        Bar bar;
+        bar.color = color;
+        bar.glyphs = barGlyphs().data() + (MAX_BAR_WIDTH - filled) * GLYPH_BYTES;
+        bar.length = width * GLYPH_BYTES;
+        return bar;
+    }
+    
+    Bar healthBarView(int current, int max, int width) {
+        return barView(Colors::RED, current, max, width);
+    }
+    
+    Bar manaBarView(int current, int max, int width) {
+        return barView(Colors::BLUE, current, max, width);
+    }
+    
+    std::ostream& operator<<(std::ostream& out, const Bar& bar) {
+        out << bar.color << "[";
+        out.write(bar.glyphs, static_cast<std::streamsize>(bar.length));
+        return out << "]" << Colors::RESET;
+    }
+    
+    static std::string barString(const Bar& bar) {
+        std::string text;
+        text.reserve(std::char_traits<char>::length(bar.color) + bar.length + 2 + std::char_traits<char>::length(RESET));
+        text += bar.color;
+        text += "[";
+        text.append(bar.glyphs, bar.length);
+        text += "]";
+        text += RESET;
+        return text;
+    }
+    
+    std::string healthBar(int current, int max, int width) {
+        return barString(healthBarView(current, max, width));
     }
     
     std::string manaBar(int current, int max, int width) {
-        if (max <= 0) max = 1;
-        int filled = (current * width) / max;
-        filled = (filled < 0) ? 0 : (filled > width) ? width : filled;
-        
-        std::stringstream ss;
-        ss << Colors::BLUE << "[";
-        
-        // Filled portion in blue
-        for (int i = 0; i < filled; i++) {
-            ss << "█";
-        }
-        
-        // Empty portion
-        for (int i = filled; i < width; i++) {
-            ss << "░";
-        }
-        
-        ss << "]" << Colors::RESET;
-        return ss.str();
+        return barString(manaBarView(current, max, width));
     }
     
     void clearScreen() {
-        std::cout << "\033[2J\033[1;1H";
+        Console::out() << "\033[2J\033[1;1H";
     }
     
     void printTitle(const std::string& title) {
-        std::cout << "\n" << Colors::BRIGHT_CYAN;
-        std::cout << "╔════════════════════════════════════════════════════════════╗\n";
-        std::cout << "║ " << std::string(title.length() < 58 ? (58 - title.length()) / 2 : 0, ' ');
-        std::cout << Colors::BRIGHT_YELLOW << title << Colors::BRIGHT_CYAN;
-        std::cout << std::string(title.length() < 58 ? (58 - title.length()) - (58 - title.length()) / 2 : 0, ' ') << " ║\n";
-        std::cout << "╚════════════════════════════════════════════════════════════╝" << Colors::RESET << "\n\n";
+        Console::out() << "\n" << Colors::BRIGHT_CYAN;
+        Console::out() << "╔════════════════════════════════════════════════════════════╗\n";
+        Console::out() << "║" << Colors::BRIGHT_YELLOW << Ui::center(title, 60) << Colors::BRIGHT_CYAN << "║\n";
+        Console::out() << "╚════════════════════════════════════════════════════════════╝" << Colors::RESET << "\n\n";
+    }
+    
+    // A horizontal box line `cells` wide
+    static std::string rule(int cells) {
+        std::string line;
+        for (int i = 0; i < cells; i++) {
+            line += "─";
+        }
+        return line;
     }
     
     void printMenu(const std::string& title, const std::vector<std::string>& options) {
-        std::cout << "\n" << Colors::BRIGHT_GREEN;
-        std::cout << "┌─ " << title << " " << std::string(title.length() > 40 ? 0 : 40 - title.length(), '-') << "┐\n";
-        std::cout << Colors::RESET;
+        Console::out() << "\n" << Colors::BRIGHT_GREEN;
+        Console::out() << "┌─ " << title << " " << rule(std::max(0, 59 - Ui::width(title))) << "┐\n";
+        Console::out() << Colors::RESET;
         
         for (const auto& option : options) {
-            std::cout << Colors::CYAN << "│ " << Colors::WHITE << option << Colors::CYAN << "\n";
+            Console::out() << Colors::CYAN << "│ " << Colors::WHITE << Ui::left(option, 61) << Colors::CYAN << "│\n";
         }
         
-        std::cout << Colors::BRIGHT_GREEN << "└" << std::string(62, '-') << "┘" << Colors::RESET << "\n\n";
+        Console::out() << Colors::BRIGHT_GREEN << "└" << rule(62) << "┘" << Colors::RESET << "\n\n";
     }
     
     // Typewriter effect - prints text character by character
     void typewriter(const std::string& text, int delayMs) {
         for (char c : text) {
-            std::cout << c << std::flush;
+            Console::out() << c << std::flush;
             delay(delayMs);
         }
     }
@@ -100,126 +138,126 @@ namespace Colors {
         int frames = durationMs / 100;
         
         for (int i = 0; i < frames; i++) {
-            std::cout << "\r" << Colors::BRIGHT_CYAN << spinner[i % 4] << " " << message << "   " << std::flush;
+            Console::out() << "\r" << Colors::BRIGHT_CYAN << spinner[i % 4] << " " << message << "   " << std::flush;
             delay(100);
         }
-        std::cout << "\r" << Colors::BRIGHT_GREEN << "✓ " << message << " Done!   \n" << Colors::RESET;
+        Console::out() << "\r" << Colors::BRIGHT_GREEN << "✓ " << message << " Done!   \n" << Colors::RESET;
     }
     
     // Battle attack animation
     void animateAttack(const std::string& attacker, const std::string& target, int damage) {
-        std::cout << "\n";
+        Console::out() << "\n";
         
         // Wind-up
-        std::cout << Colors::BRIGHT_YELLOW << attacker << " prepares to strike";
+        Console::out() << Colors::BRIGHT_YELLOW << attacker << " prepares to strike";
         for (int i = 0; i < 3; i++) {
-            std::cout << "." << std::flush;
+            Console::out() << "." << std::flush;
             delay(200);
         }
-        std::cout << "\n";
+        Console::out() << "\n";
         
         // Impact animation
         const std::string impacts[] = {"💥", "⚡", "✨", "💢"};
-        std::cout << Colors::BRIGHT_RED;
+        Console::out() << Colors::BRIGHT_RED;
         for (int i = 0; i < 3; i++) {
-            std::cout << "\r  " << impacts[i % 4] << " *SLASH* " << impacts[(i+1) % 4] << "  " << std::flush;
+            Console::out() << "\r  " << impacts[i % 4] << " *SLASH* " << impacts[(i+1) % 4] << "  " << std::flush;
             delay(150);
         }
         
         // Damage reveal
-        std::cout << "\n" << Colors::BRIGHT_WHITE << "  ➤ " << target << " takes " 
+        Console::out() << "\n" << Colors::BRIGHT_WHITE << "  ➤ " << target << " takes " 
                   << Colors::BRIGHT_RED << damage << Colors::BRIGHT_WHITE << " damage! 💔\n" << Colors::RESET;
         delay(300);
     }
     
     // Healing animation
     void animateHeal(const std::string& name, int amount) {
-        std::cout << "\n" << Colors::BRIGHT_GREEN;
+        Console::out() << "\n" << Colors::BRIGHT_GREEN;
         
         // Sparkle effect
         const std::string sparkles[] = {"✨", "💚", "✨", "💖"};
         for (int i = 0; i < 4; i++) {
-            std::cout << "\r  " << sparkles[i] << " Healing energy surrounds " << name << " " << sparkles[i] << "  " << std::flush;
+            Console::out() << "\r  " << sparkles[i] << " Healing energy surrounds " << name << " " << sparkles[i] << "  " << std::flush;
             delay(200);
         }
         
-        std::cout << "\n  ➤ " << name << " recovers " << Colors::BRIGHT_GREEN << "+" << amount 
+        Console::out() << "\n  ➤ " << name << " recovers " << Colors::BRIGHT_GREEN << "+" << amount 
                   << " HP" << Colors::RESET << "! 💚\n";
         delay(300);
     }
     
     // Level up animation
     void animateLevelUp(int newLevel) {
-        std::cout << "\n";
+        Console::out() << "\n";
         
         // Flash effect
         for (int i = 0; i < 3; i++) {
-            std::cout << "\r" << Colors::BRIGHT_YELLOW << "  🎆 ★ LEVEL UP! ★ 🎆  " << std::flush;
+            Console::out() << "\r" << Colors::BRIGHT_YELLOW << "  🎆 ★ LEVEL UP! ★ 🎆  " << std::flush;
             delay(200);
-            std::cout << "\r" << Colors::BRIGHT_CYAN << "  🎆 ★ LEVEL UP! ★ 🎆  " << std::flush;
+            Console::out() << "\r" << Colors::BRIGHT_CYAN << "  🎆 ★ LEVEL UP! ★ 🎆  " << std::flush;
             delay(200);
         }
         
-        std::cout << "\n\n" << Colors::BRIGHT_YELLOW;
-        std::cout << "  ╔═══════════════════════════════╗\n";
-        std::cout << "  ║  🎉 CONGRATULATIONS! 🎉       ║\n";
-        std::cout << "  ║  You are now Level " << std::setw(2) << newLevel << "!        ║\n";
-        std::cout << "  ╚═══════════════════════════════╝\n" << Colors::RESET;
+        Console::out() << "\n\n" << Colors::BRIGHT_YELLOW;
+        Console::out() << "  ╔═══════════════════════════════╗\n";
+        Console::out() << "  ║" << Ui::left("  🎉 CONGRATULATIONS! 🎉", 31) << "║\n";
+        Console::out() << "  ║" << Ui::left("  You are now Level " + std::to_string(newLevel) + "!", 31) << "║\n";
+        Console::out() << "  ╚═══════════════════════════════╝\n" << Colors::RESET;
         delay(500);
     }
     
     // Victory animation
     void animateVictory() {
-        std::cout << "\n";
+        Console::out() << "\n";
         
         // Fireworks effect
         const std::string fireworks[] = {"🎆", "🎇", "✨", "🌟", "⭐"};
         for (int round = 0; round < 2; round++) {
             for (int i = 0; i < 5; i++) {
-                std::cout << "\r  ";
+                Console::out() << "\r  ";
                 for (int j = 0; j < 5; j++) {
-                    std::cout << fireworks[(i + j) % 5] << " ";
+                    Console::out() << fireworks[(i + j) % 5] << " ";
                 }
-                std::cout << std::flush;
+                Console::out() << std::flush;
                 delay(150);
             }
         }
         
-        std::cout << "\n\n" << Colors::BRIGHT_GREEN;
-        std::cout << "  ╔═══════════════════════════════════════╗\n";
-        std::cout << "  ║       🏆 VICTORY! 🏆                  ║\n";
-        std::cout << "  ║   The enemy has been defeated!       ║\n";
-        std::cout << "  ╚═══════════════════════════════════════╝\n" << Colors::RESET;
+        Console::out() << "\n\n" << Colors::BRIGHT_GREEN;
+        Console::out() << "  ╔═══════════════════════════════════════╗\n";
+        Console::out() << "  ║" << Ui::center("🏆 VICTORY! 🏆", 39) << "║\n";
+        Console::out() << "  ║" << Ui::center("The enemy has been defeated!", 39) << "║\n";
+        Console::out() << "  ╚═══════════════════════════════════════╝\n" << Colors::RESET;
     }
     
     // Defeat animation
     void animateDefeat() {
-        std::cout << "\n" << Colors::BRIGHT_RED;
+        Console::out() << "\n" << Colors::BRIGHT_RED;
         
         // Fade effect
         for (int i = 0; i < 3; i++) {
-            std::cout << "\r  💀 You have fallen... 💀  " << std::flush;
+            Console::out() << "\r  💀 You have fallen... 💀  " << std::flush;
             delay(300);
-            std::cout << "\r                              " << std::flush;
+            Console::out() << "\r                              " << std::flush;
             delay(200);
         }
         
-        std::cout << "\n\n";
-        std::cout << "  ╔═══════════════════════════════════════╗\n";
-        std::cout << "  ║         💀 DEFEAT 💀                  ║\n";
-        std::cout << "  ║   Your journey ends here...          ║\n";
-        std::cout << "  ╚═══════════════════════════════════════╝\n" << Colors::RESET;
+        Console::out() << "\n\n";
+        Console::out() << "  ╔═══════════════════════════════════════╗\n";
+        Console::out() << "  ║" << Ui::center("💀 DEFEAT 💀", 39) << "║\n";
+        Console::out() << "  ║" << Ui::center("Your journey ends here...", 39) << "║\n";
+        Console::out() << "  ╚═══════════════════════════════════════╝\n" << Colors::RESET;
     }
     
     // Flash text with color
     void flashText(const std::string& text, const char* color, int times) {
         for (int i = 0; i < times; i++) {
-            std::cout << "\r" << color << text << Colors::RESET << std::flush;
+            Console::out() << "\r" << color << text << Colors::RESET << std::flush;
             delay(200);
-            std::cout << "\r" << std::string(text.length() + 10, ' ') << std::flush;
+            Console::out() << "\r" << std::string(text.length() + 10, ' ') << std::flush;
             delay(100);
         }
-        std::cout << "\r" << color << text << Colors::RESET << "\n";
+        Console::out() << "\r" << color << text << Colors::RESET << "\n";
     }
     
     // Animated progress bar
@@ -230,24 +268,24 @@ namespace Colors {
             int filled = (progress * width) / max;
             filled = (filled < 0) ? 0 : (filled > width) ? width : filled;
             
-            std::cout << "\r" << Colors::BRIGHT_CYAN << label << " [";
-            std::cout << Colors::BRIGHT_GREEN;
-            for (int i = 0; i < filled; i++) std::cout << "█";
-            std::cout << Colors::GRAY;
-            for (int i = filled; i < width; i++) std::cout << "░";
-            std::cout << Colors::BRIGHT_CYAN << "] " << (progress * 100 / max) << "%" << std::flush;
+            Console::out() << "\r" << Colors::BRIGHT_CYAN << label << " [";
+            Console::out() << Colors::BRIGHT_GREEN;
+            for (int i = 0; i < filled; i++) Console::out() << "█";
+            Console::out() << Colors::GRAY;
+            for (int i = filled; i < width; i++) Console::out() << "░";
+            Console::out() << Colors::BRIGHT_CYAN << "] " << (progress * 100 / max) << "%" << std::flush;
             
             delay(30);
         }
         
         // Final state
         int filled = (current * width) / max;
-        std::cout << "\r" << Colors::BRIGHT_CYAN << label << " [";
-        std::cout << Colors::BRIGHT_GREEN;
-        for (int i = 0; i < filled; i++) std::cout << "█";
-        std::cout << Colors::GRAY;
-        for (int i = filled; i < width; i++) std::cout << "░";
-        std::cout << Colors::BRIGHT_CYAN << "] " << (current * 100 / max) << "%" << Colors::RESET << "\n";
+        Console::out() << "\r" << Colors::BRIGHT_CYAN << label << " [";
+        Console::out() << Colors::BRIGHT_GREEN;
+        for (int i = 0; i < filled; i++) Console::out() << "█";
+        Console::out() << Colors::GRAY;
+        for (int i = filled; i < width; i++) Console::out() << "░";
+        Console::out() << Colors::BRIGHT_CYAN << "] " << (current * 100 / max) << "%" << Colors::RESET << "\n";
     }
     
     // Animated story intro
@@ -256,108 +294,102 @@ namespace Colors {
         delay(500);
         
         // Scene 1: The peaceful kingdom
-        std::cout << Colors::BRIGHT_CYAN;
-        std::cout << "\n\n";
-        std::cout << "    ╔═══════════════════════════════════════════════════════════╗\n";
-        std::cout << "    ║                                                           ║\n";
-        std::cout << "    ║               " << Colors::BRIGHT_YELLOW << "☀️  THE KINGDOM OF ARKANIA  ☀️" << Colors::BRIGHT_CYAN << "              ║\n";
-        std::cout << "    ║                                                           ║\n";
-        std::cout << "    ╚═══════════════════════════════════════════════════════════╝\n\n";
-        std::cout << Colors::RESET;
+        Console::out() << Colors::BRIGHT_CYAN;
+        Console::out() << "\n\n";
+        Console::out() << "    ╔═══════════════════════════════════════════════════════════╗\n";
+        Console::out() << "    ║                                                           ║\n";
+        Console::out() << "    ║" << Colors::BRIGHT_YELLOW << Ui::center("☀️ THE KINGDOM OF ARKANIA ☀️", 59) << Colors::BRIGHT_CYAN << "║\n";
+        Console::out() << "    ║                                                           ║\n";
+        Console::out() << "    ╚═══════════════════════════════════════════════════════════╝\n\n";
+        Console::out() << Colors::RESET;
         delay(1500);
         
-        std::cout << Colors::WHITE;
+        Console::out() << Colors::WHITE;
         typewriter("    Long ago, the Kingdom of Arkania flourished under the light\n", 35);
         typewriter("    of the ", 35);
-        std::cout << Colors::BRIGHT_YELLOW << "Crystal of Dawn" << Colors::WHITE;
+        Console::out() << Colors::BRIGHT_YELLOW << "Crystal of Dawn" << Colors::WHITE;
         typewriter(" — a magical artifact that brought\n", 35);
         typewriter("    peace and prosperity to all who lived within its glow...\n\n", 35);
         delay(1000);
         
         // Scene 2: The darkness rises
-        std::cout << Colors::BRIGHT_RED;
-        std::cout << "\n    ░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░\n";
-        std::cout << Colors::RESET;
+        Console::out() << Colors::BRIGHT_RED;
+        Console::out() << "\n    ░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░\n";
+        Console::out() << Colors::RESET;
         delay(800);
         
-        std::cout << Colors::RED;
+        Console::out() << Colors::RED;
         typewriter("\n    But darkness came...\n\n", 50);
         delay(500);
         
-        std::cout << Colors::WHITE;
+        Console::out() << Colors::WHITE;
         typewriter("    The ", 35);
-        std::cout << Colors::BRIGHT_RED << "Dark Lord Malachar" << Colors::WHITE;
+        Console::out() << Colors::BRIGHT_RED << "Dark Lord Malachar" << Colors::WHITE;
         typewriter(" rose from the shadows of the\n", 35);
         typewriter("    ", 35);
-        std::cout << Colors::MAGENTA << "Dark Citadel" << Colors::WHITE;
+        Console::out() << Colors::MAGENTA << "Dark Citadel" << Colors::WHITE;
         typewriter(". With his army of monsters, he shattered\n", 35);
         typewriter("    the Crystal and plunged the land into chaos.\n\n", 35);
         delay(1000);
         
         // Scene 3: The hero's call
-        std::cout << Colors::BRIGHT_MAGENTA;
-        std::cout << "\n    ✦ ══════════════════════════════════════════════════════ ✦\n\n";
-        std::cout << Colors::RESET;
+        Console::out() << Colors::BRIGHT_MAGENTA;
+        Console::out() << "\n    ✦ ══════════════════════════════════════════════════════ ✦\n\n";
+        Console::out() << Colors::RESET;
         delay(600);
         
-        std::cout << Colors::BRIGHT_CYAN;
+        Console::out() << Colors::BRIGHT_CYAN;
         typewriter("    Now, a hero emerges...\n\n", 40);
         delay(500);
         
-        std::cout << Colors::BRIGHT_GREEN << "    ⚔️  ";
-        std::cout << Colors::BRIGHT_WHITE << playerName << Colors::GREEN;
+        Console::out() << Colors::BRIGHT_GREEN << "    ⚔️ ";
+        Console::out() << Colors::BRIGHT_WHITE << playerName << Colors::GREEN;
         typewriter(", a brave ", 30);
-        std::cout << Colors::BRIGHT_YELLOW << playerClass << Colors::GREEN;
+        Console::out() << Colors::BRIGHT_YELLOW << playerClass << Colors::GREEN;
         typewriter(",\n", 30);
         typewriter("        has answered the call to adventure!\n\n", 35);
         delay(800);
         
         // Scene 4: The quest
-        std::cout << Colors::BRIGHT_YELLOW;
-        std::cout << "\n    ╭───────────────────────────────────────────────────────────╮\n";
-        std::cout << "    │                    " << Colors::BRIGHT_WHITE << "⚡ YOUR QUEST ⚡" << Colors::BRIGHT_YELLOW << "                      │\n";
-        std::cout << "    ╰───────────────────────────────────────────────────────────╯\n\n";
-        std::cout << Colors::RESET;
+        Console::out() << Colors::BRIGHT_YELLOW;
+        Console::out() << "\n    ╭───────────────────────────────────────────────────────────╮\n";
+        Console::out() << "    │" << Colors::BRIGHT_WHITE << Ui::center("⚡ YOUR QUEST ⚡", 59) << Colors::BRIGHT_YELLOW << "│\n";
+        Console::out() << "    ╰───────────────────────────────────────────────────────────╯\n\n";
+        Console::out() << Colors::RESET;
         delay(500);
         
-        std::cout << Colors::WHITE;
-        typewriter("    🗺️  Explore the four regions of Arkania:\n", 30);
+        Console::out() << Colors::WHITE;
+        typewriter("    🗺️ Explore the four regions of Arkania:\n", 30);
         delay(300);
-        std::cout << Colors::GREEN;
+        Console::out() << Colors::GREEN;
         typewriter("        🌲 Verdant Woods - Where your journey begins\n", 25);
-        std::cout << Colors::YELLOW;
-        typewriter("        🏜️  Scorched Dunes - The unforgiving desert\n", 25);
-        std::cout << Colors::CYAN;
-        typewriter("        ❄️  Frost Peaks - The frozen mountains\n", 25);
-        std::cout << Colors::RED;
+        Console::out() << Colors::YELLOW;
+        typewriter("        🏜️ Scorched Dunes - The unforgiving desert\n", 25);
+        Console::out() << Colors::CYAN;
+        typewriter("        ❄️ Frost Peaks - The frozen mountains\n", 25);
+        Console::out() << Colors::RED;
         typewriter("        🏰 Dark Citadel - Malachar's fortress\n\n", 25);
         delay(600);
         
-        std::cout << Colors::BRIGHT_WHITE;
+        Console::out() << Colors::BRIGHT_WHITE;
         typewriter("    💎 Collect the ", 30);
-        std::cout << Colors::BRIGHT_CYAN << "Crystal Shards" << Colors::BRIGHT_WHITE;
+        Console::out() << Colors::BRIGHT_CYAN << "Crystal Shards" << Colors::BRIGHT_WHITE;
         typewriter(" scattered across the land.\n", 30);
-        typewriter("    ⚔️  Defeat the Dark Lord and restore peace to Arkania!\n\n", 30);
+        typewriter("    ⚔️ Defeat the Dark Lord and restore peace to Arkania!\n\n", 30);
         delay(1000);
         
         // Final transition
-        std::cout << Colors::BRIGHT_MAGENTA;
-        std::cout << "\n    ════════════════════════════════════════════════════════════\n";
-        std::cout << Colors::RESET;
+        Console::out() << Colors::BRIGHT_MAGENTA;
+        Console::out() << "\n    ════════════════════════════════════════════════════════════\n";
+        Console::out() << Colors::RESET;
         delay(500);
         
-        std::cout << Colors::BRIGHT_GREEN;
+        Console::out() << Colors::BRIGHT_GREEN;
         typewriter("\n    Your legend begins now...\n", 50);
         delay(800);
         
-        std::cout << Colors::BRIGHT_YELLOW;
+        Console::out() << Colors::BRIGHT_YELLOW;
         typewriter("\n    Press ENTER to begin your adventure... ", 30);
-        std::cout << Colors::RESET;
-        
-        // Wait for enter
-        std::string dummy;
-        std::getline(std::cin, dummy);
-        
-        clearScreen();
+        Console::out() << Colors::RESET << std::flush;
     }
 }
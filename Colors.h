@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <ostream>
 
 // ANSI Color Codes for Terminal Output
 namespace Colors {
@@ -47,48 +48,48 @@ namespace Colors {
     
     // Emojis
     namespace Emoji {
-        constexpr const char* WARRIOR = "🗡️ ";
+        constexpr const char* WARRIOR = "🗡️";
         constexpr const char* MAGE = "🧙";
         constexpr const char* ARCHER = "🏹";
-        constexpr const char* HEALTH = "❤️ ";
+        constexpr const char* HEALTH = "❤️";
         constexpr const char* MANA = "💙";
-        constexpr const char* SWORD = "⚔️ ";
-        constexpr const char* SHIELD = "🛡️ ";
+        constexpr const char* SWORD = "⚔️";
+        constexpr const char* SHIELD = "🛡️";
         constexpr const char* GOLD = "💰";
         constexpr const char* EXPERIENCE = "⭐";
         constexpr const char* LEVEL_UP = "🎆";
         constexpr const char* VICTORY = "🏆";
         constexpr const char* DEFEAT = "💀";
         constexpr const char* FIRE = "🔥";
-        constexpr const char* FROST = "❄️ ";
-        constexpr const char* POISON = "☠️ ";
+        constexpr const char* FROST = "❄️";
+        constexpr const char* POISON = "☠️";
         constexpr const char* GRASS = "🌿";
         constexpr const char* FOREST = "🌲";
-        constexpr const char* MOUNTAIN = "⛰️ ";
+        constexpr const char* MOUNTAIN = "⛰️";
         constexpr const char* WATER = "💧";
-        constexpr const char* DESERT = "🏜️ ";
-        constexpr const char* DUNGEON = "🏚️ ";
+        constexpr const char* DESERT = "🏜️";
+        constexpr const char* DUNGEON = "🏚️";
         constexpr const char* CASTLE = "🏰";
-        constexpr const char* TOWN = "🏘️ ";
+        constexpr const char* TOWN = "🏘️";
         constexpr const char* SHOP = "🏪";
         constexpr const char* PLAYER = "🧑";
         constexpr const char* ENEMY = "👹";
         constexpr const char* GOBLIN = "👺";
         constexpr const char* TROLL = "🪨";
-        constexpr const char* BANDIT = "🗡️ ";
+        constexpr const char* BANDIT = "🗡️";
         constexpr const char* BOSS = "👹";
         constexpr const char* POTION = "🧪";
         constexpr const char* SCROLL = "📜";
         constexpr const char* CHEST = "💎";
-        constexpr const char* MAP = "🗺️ ";
-        constexpr const char* MOVE_UP = "⬆️ ";
-        constexpr const char* MOVE_DOWN = "⬇️ ";
-        constexpr const char* MOVE_LEFT = "⬅️ ";
-        constexpr const char* MOVE_RIGHT = "➡️ ";
+        constexpr const char* MAP = "🗺️";
+        constexpr const char* MOVE_UP = "⬆️";
+        constexpr const char* MOVE_DOWN = "⬇️";
+        constexpr const char* MOVE_LEFT = "⬅️";
+        constexpr const char* MOVE_RIGHT = "➡️";
         constexpr const char* ATTACK = "💥";
-        constexpr const char* DEFEND = "🛡️ ";
+        constexpr const char* DEFEND = "🛡️";
         constexpr const char* ITEM = "🎒";
-        constexpr const char* INFO = "ℹ️ ";
+        constexpr const char* INFO = "ℹ️";
         constexpr const char* MENU = "📋";
         constexpr const char* QUESTION = "❓";
         constexpr const char* CHECK = "✅";
@@ -100,6 +101,19 @@ namespace Colors {
     std::string colorize(const std::string& text, const char* color);
     std::string healthBar(int current, int max, int width = 20);
     std::string manaBar(int current, int max, int width = 20);
+
+    // The same bars without building a string: the glyphs are a slice of
+    // one table made on first use, so streaming a Bar allocates nothing.
+    // Widths above MAX_BAR_WIDTH are drawn at that width.
+    const int MAX_BAR_WIDTH = 64;
+    struct Bar {
+        const char* color;
+        const char* glyphs;   // filled then empty blocks, UTF-8
+        size_t length;        // bytes of glyphs
+    };
+    Bar healthBarView(int current, int max, int width = 20);
+    Bar manaBarView(int current, int max, int width = 20);
+    std::ostream& operator<<(std::ostream& out, const Bar& bar);
     void clearScreen();
     void printTitle(const std::string& title);
     void printMenu(const std::string& title, const std::vector<std::string>& options);
@@ -115,8 +129,12 @@ namespace Colors {
     void flashText(const std::string& text, const char* color, int times = 3);
     void progressBar(const std::string& label, int current, int max, int width = 30);
     void delay(int milliseconds);
+    // Scripted sessions turn animations off: delays are ignored. Otherwise
+    // a delay ends an animation frame (Animation::hold) and returns at once.
+    void setAnimationsEnabled(bool enabled);
+    bool animationsEnabled();
     
-    // Story intro animation
+    // Story intro animation; ends on a "press ENTER" prompt for the caller
     void playIntroStory(const std::string& playerName, const std::string& playerClass);
 }
 
@@ -0,0 +1,320 @@
+#include "CommandSource.h"
+#include "Console.h"
+#include <iostream>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <unistd.h>
+#include <poll.h>
+#include <termios.h>
+#include <csignal>
+
+std::string CommandSource::trim(const std::string& line) {
+    size_t start = line.find_first_not_of(" \t\r\n");
+    size_t end = line.find_last_not_of(" \t\r\n");
+    return (start == std::string::npos) ? std::string() : line.substr(start, end - start + 1);
+}
+
+int CommandSource::parseNumber(const std::string& line, int fallback) {
+    std::string text = trim(line);
+    char* end = nullptr;
+    long value = std::strtol(text.c_str(), &end, 10);
+    return (end == text.c_str()) ? fallback : static_cast<int>(value);
+}
+
+char CommandSource::parseChoice(const std::string& line, char fallback) {
+    std::string text = trim(line);
+    return text.empty() ? fallback : static_cast<char>(std::toupper(static_cast<unsigned char>(text[0])));
+}
+
+bool CommandSource::readLine(std::string& line) {
+    line.clear();
+    if (exhausted || !nextLine(line)) {
+        exhausted = true;
+        line.clear();
+        return false;
+    }
+    line = trim(line);
+    return true;
+}
+
+int CommandSource::readNumber(int fallback) {
+    std::string line;
+    return readLine(line) ? parseNumber(line, fallback) : fallback;
+}
+
+char CommandSource::readChoice(char fallback) {
+    std::string line;
+    return readLine(line) ? parseChoice(line, fallback) : fallback;
+}
+
+bool TerminalSource::nextLine(std::string& line) {
+    if (!std::getline(std::cin, line)) {
+        // A read error on a terminal is as final as EOF
+        std::cin.clear();
+        return false;
+    }
+    return true;
+}
+
+bool TerminalSource::isInteractive() const {
+    return isatty(STDIN_FILENO) != 0;
+}
+
+bool TerminalSource::waitForInput(int timeoutMs) {
+    pollfd stdinFd;
+    stdinFd.fd = STDIN_FILENO;
+    stdinFd.events = POLLIN;
+    stdinFd.revents = 0;
+    return poll(&stdinFd, 1, timeoutMs) != 0; // errors and hangups count: reading will report them
+}
+
+// The terminal's settings before raw mode, for the destructor and for
+// signals that would otherwise leave the shell without echo
+static termios savedTerminal;
+static volatile sig_atomic_t terminalSaved = 0;
+
+static void restoreTerminalOnSignal(int signal) {
+    if (terminalSaved) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &savedTerminal);
+    }
+    std::signal(signal, SIG_DFL);
+    std::raise(signal);
+}
+
+KeyboardSource::KeyboardSource() : raw(false), singleKeys(false), ended(false) {
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &savedTerminal) != 0) {
+        return;
+    }
+    termios keys = savedTerminal;
+    keys.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO);
+    keys.c_cc[VMIN] = 1;
+    keys.c_cc[VTIME] = 0;
+    terminalSaved = 1;
+    std::signal(SIGINT, restoreTerminalOnSignal);
+    std::signal(SIGTERM, restoreTerminalOnSignal);
+    raw = tcsetattr(STDIN_FILENO, TCSANOW, &keys) == 0;
+}
+
+KeyboardSource::~KeyboardSource() {
+    if (raw) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &savedTerminal);
+    }
+    terminalSaved = 0;
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+}
+
+bool KeyboardSource::fill(int timeoutMs) {
+    if (ended) {
+        return !pending.empty();
+    }
+    pollfd stdinFd;
+    stdinFd.fd = STDIN_FILENO;
+    stdinFd.events = POLLIN;
+    stdinFd.revents = 0;
+    int ready = poll(&stdinFd, 1, timeoutMs);
+    if (ready == 0 || (ready < 0 && errno == EINTR)) {
+        return true;
+    }
+    char bytes[256];
+    ssize_t count = ready > 0 ? read(STDIN_FILENO, bytes, sizeof(bytes)) : -1;
+    if (count <= 0) {
+        if (count < 0 && errno == EINTR) {
+            return true;
+        }
+        ended = true;
+        return !pending.empty();
+    }
+    if (pending.empty()) {
+        pendingSince = std::chrono::steady_clock::now();
+    }
+    pending.append(bytes, static_cast<size_t>(count));
+    return true;
+}
+
+bool KeyboardSource::waitForInput(int timeoutMs) {
+    if (pending.empty() && !ended) {
+        fill(timeoutMs);
+    }
+    return !pending.empty() || ended;
+}
+
+bool KeyboardSource::arrivalTime(std::chrono::steady_clock::time_point& when) const {
+    when = arrived;
+    return raw;
+}
+
+char KeyboardSource::takeKey() {
+    char c = pending[0];
+    if (c == '\033') {
+        // An arrow key's sequence may still be on its way
+        if (pending.size() < 3) {
+            fill(25);
+        }
+        if (pending.size() >= 3 && (pending[1] == '[' || pending[1] == 'O')) {
+            char arrow = pending[2];
+            pending.erase(0, 3);
+            switch (arrow) {
+                case 'A': return 'W';
+                case 'B': return 'S';
+                case 'C': return 'D';
+                case 'D': return 'A';
+                default: return 0; // some other key: ignored
+            }
+        }
+        pending.erase(0, 1);
+        return 0;
+    }
+    pending.erase(0, 1);
+    if (c == '\r' || c == '\n') {
+        return '\n';
+    }
+    if (c == 0x04) {
+        ended = true; // Ctrl-D
+        pending.clear();
+        return 0;
+    }
+    return std::isprint(static_cast<unsigned char>(c)) ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : 0;
+}
+
+bool KeyboardSource::nextKeys(std::string& line) {
+    while (true) {
+        if (pending.empty() && !fill(-1)) {
+            return false;
+        }
+        if (pending.empty()) {
+            continue;
+        }
+        arrived = pendingSince;
+        char key = takeKey();
+        if (key == '\n') {
+            return true; // an empty line
+        }
+        if (key == 0) {
+            if (ended && pending.empty()) {
+                return false;
+            }
+            continue;
+        }
+        line = key;
+        if (key == '/') {
+            // Admin commands (/latency) are typed out in full
+            std::cout << key << std::flush;
+            return nextEditedLine(line);
+        }
+        // Repeats of a movement key that are already here come along
+        bool movement = key == 'W' || key == 'A' || key == 'S' || key == 'D';
+        while (movement) {
+            if (pending.empty()) {
+                fill(0);
+            }
+            if (pending.empty() || (pending[0] == '\033' && pending.size() < 3)) {
+                break; // nothing more yet, or a key still arriving
+            }
+            std::string before = pending;
+            if (takeKey() != key) {
+                pending = before;
+                break;
+            }
+            line += key;
+        }
+        return true;
+    }
+}
+
+bool KeyboardSource::nextEditedLine(std::string& line) {
+    while (true) {
+        if (pending.empty() && !fill(-1)) {
+            std::cout << "\n" << std::flush;
+            return false;
+        }
+        if (pending.empty()) {
+            continue;
+        }
+        arrived = pendingSince;
+        char c = pending[0];
+        pending.erase(0, 1);
+        if (c == '\r' || c == '\n') {
+            std::cout << "\n" << std::flush;
+            return true;
+        }
+        if (c == 0x04 && line.empty()) {
+            ended = true;
+            pending.clear();
+            return false;
+        }
+        if (c == 0x7F || c == '\b') {
+            if (!line.empty()) {
+                // Back over a whole UTF-8 character
+                while (line.size() > 1 && (static_cast<unsigned char>(line.back()) & 0xC0) == 0x80) {
+                    line.pop_back();
+                }
+                line.pop_back();
+                std::cout << "\b \b" << std::flush;
+            }
+        } else if (c == '\033') {
+            pending.insert(0, 1, c);
+            takeKey(); // arrows and the like mean nothing here
+        } else if (static_cast<unsigned char>(c) >= 0x20) {
+            line += c;
+            std::cout << c << std::flush;
+        }
+    }
+}
+
+bool KeyboardSource::nextLine(std::string& line) {
+    if (!raw) {
+        if (!std::getline(std::cin, line)) {
+            std::cin.clear();
+            return false;
+        }
+        return true;
+    }
+    return singleKeys ? nextKeys(line) : nextEditedLine(line);
+}
+
+ScriptSource::ScriptSource(const std::string& filename, bool echoCommands)
+    : file(filename), echo(echoCommands) {
+}
+
+bool ScriptSource::nextLine(std::string& line) {
+    while (std::getline(file, line)) {
+        if (!line.empty() && line[0] == '#') {
+            continue;
+        }
+        if (echo) {
+            Console::out() << line << "\n";
+        }
+        return true;
+    }
+    return false;
+}
+
+bool QueueSource::nextLine(std::string& line) {
+    if (lines.empty()) {
+        return false;
+    }
+    line.swap(lines.front());
+    lines.pop_front();
+    return true;
+}
+
+void QueueSource::push(const std::string& line) {
+    lines.push_back(line);
+}
+
+void QueueSource::pushLines(const std::string& text) {
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) {
+            if (start < text.size()) {
+                lines.push_back(text.substr(start));
+            }
+            break;
+        }
+        lines.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+}
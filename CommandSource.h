@@ -0,0 +1,133 @@
+#ifndef COMMANDSOURCE_H
+#define COMMANDSOURCE_H
+
+#include <string>
+#include <deque>
+#include <fstream>
+#include <chrono>
+
+// Where the game reads player input from. Every prompt reads exactly one
+// line, so the same session can be driven by a person at a terminal, a
+// script file, or a program pushing commands into a queue.
+class CommandSource {
+private:
+    bool exhausted;
+
+protected:
+    // Next raw line without its newline; false when there is no more input
+    virtual bool nextLine(std::string& line) = 0;
+
+public:
+    CommandSource() : exhausted(false) {}
+    virtual ~CommandSource() {}
+
+    // True when a person is typing, so pauses and animations make sense
+    virtual bool isInteractive() const { return false; }
+    // True once input is waiting, giving up after timeoutMs. Only a person
+    // makes the game wait; other sources always have their input ready.
+    virtual bool waitForInput(int) { return true; }
+    // The next prompt takes single keys (a keypress is a whole command) or
+    // not; only a source that reads keystrokes cares
+    virtual void expectKeys(bool) {}
+    // When the line last read arrived, for a source that can tell
+    virtual bool arrivalTime(std::chrono::steady_clock::time_point&) const { return false; }
+
+    // One line of input with surrounding whitespace trimmed; false once
+    // input has run out (and every read after that)
+    bool readLine(std::string& line);
+    // First integer on the line, or the fallback if there is none
+    int readNumber(int fallback);
+    // First character of the line, upper-cased, or the fallback if empty
+    char readChoice(char fallback);
+
+    bool isExhausted() const { return exhausted; }
+
+    // The same parsing for lines that arrive some other way
+    static std::string trim(const std::string& line);
+    static int parseNumber(const std::string& line, int fallback);
+    static char parseChoice(const std::string& line, char fallback);
+};
+
+// Lines typed on standard input
+class TerminalSource : public CommandSource {
+protected:
+    bool nextLine(std::string& line) override;
+
+public:
+    bool isInteractive() const override;
+    bool waitForInput(int timeoutMs) override;
+};
+
+// Keystrokes from a terminal in raw (non-canonical, no echo) mode, read
+// with poll() like the rest of the game's input. Where the game expects
+// single keys a keypress is a whole command, the arrow keys are W/A/S/D,
+// and a held key's repeats that are already waiting arrive together as
+// one line ("DDDD") so the game walks them all and redraws once. Other
+// prompts are edited and echoed as lines. The destructor (or SIGINT and
+// SIGTERM) puts the terminal back.
+class KeyboardSource : public CommandSource {
+private:
+    bool raw;
+    bool singleKeys;
+    std::string pending;   // read but not yet used
+    bool ended;            // end of input seen on the terminal
+    std::chrono::steady_clock::time_point pendingSince;
+    std::chrono::steady_clock::time_point arrived;
+
+    // Read whatever is there, waiting up to timeoutMs (-1: until something
+    // comes); false once input has ended and nothing is pending
+    bool fill(int timeoutMs);
+    // One key off the front of pending: its letter, '\n', or 0 for none
+    char takeKey();
+    bool nextKeys(std::string& line);
+    bool nextEditedLine(std::string& line);
+
+protected:
+    bool nextLine(std::string& line) override;
+
+public:
+    KeyboardSource();
+    ~KeyboardSource();
+    KeyboardSource(const KeyboardSource&) = delete;
+    KeyboardSource& operator=(const KeyboardSource&) = delete;
+
+    // False when standard input is not a terminal
+    bool isRaw() const { return raw; }
+    bool isInteractive() const override { return true; }
+    bool waitForInput(int timeoutMs) override;
+    void expectKeys(bool single) override { singleKeys = single; }
+    bool arrivalTime(std::chrono::steady_clock::time_point& when) const override;
+};
+
+// Lines from a script file. Lines starting with '#' are comments; each
+// command is echoed after its prompt so transcripts read like a session.
+class ScriptSource : public CommandSource {
+private:
+    std::ifstream file;
+    bool echo;
+
+protected:
+    bool nextLine(std::string& line) override;
+
+public:
+    explicit ScriptSource(const std::string& filename, bool echoCommands = true);
+    bool isOpen() const { return file.is_open(); }
+};
+
+// Lines pushed by the program driving the session. Reading from an empty
+// queue ends the input, so push everything a step needs before running it.
+class QueueSource : public CommandSource {
+private:
+    std::deque<std::string> lines;
+
+protected:
+    bool nextLine(std::string& line) override;
+
+public:
+    void push(const std::string& line);
+    // Queue several commands at once, one per '\n'-separated line
+    void pushLines(const std::string& text);
+    size_t pending() const { return lines.size(); }
+};
+
+#endif
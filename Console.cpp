@@ -0,0 +1,14 @@
+#include "Console.h"
+#include <iostream>
+
+namespace Console {
+    static thread_local std::ostream* current = nullptr;
+
+    std::ostream& out() {
+        return current ? *current : std::cout;
+    }
+
+    void redirect(std::ostream* stream) {
+        current = stream;
+    }
+}
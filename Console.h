@@ -0,0 +1,15 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <ostream>
+
+// Destination for all game text. It is std::cout unless the current thread
+// has redirected it, which is how a server gives each session its own
+// output without touching the display code.
+namespace Console {
+    std::ostream& out();
+    // Send this thread's output to the stream (nullptr restores std::cout)
+    void redirect(std::ostream* stream);
+}
+
+#endif
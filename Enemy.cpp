@@ -1,4 +1,5 @@
 #include "Enemy.h"
+#include "Console.h"
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
@@ -32,11 +33,11 @@ void Enemy::takeDamage(int damage) {
 }
 
 void Enemy::displayStats() const {
-    std::cout << "\n=== ENEMY STATS ===\n";
-    std::cout << "Name: " << name << "\n";
-    std::cout << "Level: " << level << "\n";
-    std::cout << "Health: " << health << "/" << maxHealth << "\n";
-    std::cout << "Strength: " << strength << "\n";
-    std::cout << "Defense: " << defense << "\n";
+    Console::out() << "\n=== ENEMY STATS ===\n";
+    Console::out() << "Name: " << name << "\n";
+    Console::out() << "Level: " << level << "\n";
+    Console::out() << "Health: " << health << "/" << maxHealth << "\n";
+    Console::out() << "Strength: " << strength << "\n";
+    Console::out() << "Defense: " << defense << "\n";
 }
 
@@ -0,0 +1,48 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <chrono>
+#include <functional>
+
+// Decides whether a screen that only shows the current state (the map and
+// actions menu drawn when a turn ends) is worth drawing. When commands
+// come faster than the display takes frames (pasted or scripted input, a
+// slow link), drawing and flushing every one of them only holds the player
+// back. A pacer lets a frame through when no newer command is waiting, and
+// otherwise at most once per interval and only while the output keeps up;
+// a dropped frame is left to the turn that answers the waiting command, so
+// the screen always ends on the latest state. Without probes every frame
+// is drawn.
+class FramePacer {
+public:
+    typedef std::function<bool()> Probe;
+    static const int DEFAULT_INTERVAL_MS = 33; // about 30 frames a second
+
+private:
+    Probe inputWaiting;   // a newer command has already arrived
+    Probe outputBehind;   // the reader has not taken the last frame yet
+    std::chrono::steady_clock::duration interval;
+    std::chrono::steady_clock::time_point lastFrame;
+
+public:
+    FramePacer() : interval(std::chrono::milliseconds(DEFAULT_INTERVAL_MS)) {}
+    FramePacer(Probe waiting, Probe behind, int intervalMs = DEFAULT_INTERVAL_MS)
+        : inputWaiting(waiting), outputBehind(behind), interval(std::chrono::milliseconds(intervalMs)) {}
+
+    // True when the frame for the state now should be drawn, which counts
+    // it as drawn
+    bool due() {
+        if (!inputWaiting || !inputWaiting()) {
+            lastFrame = std::chrono::steady_clock::now();
+            return true;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastFrame < interval || (outputBehind && outputBehind())) {
+            return false;
+        }
+        lastFrame = now;
+        return true;
+    }
+};
+
+#endif
@@ -1,14 +1,24 @@
 #include "Game.h"
 #include "Colors.h"
+#include "Console.h"
+#include "SaveStore.h"
+#include "Latency.h"
+#include "Trace.h"
+#include "Animation.h"
+#include "Ui.h"
+#include "Terminal.h"
 #include <iostream>
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
 #include <ctime>
 #include <algorithm>
 #include <cctype>
 #include <vector>
 #include <string>
 #include <limits>
-#include <iomanip>
+#include <mutex>
+#include <set>
 #include <unistd.h>
 #include <mach-o/dyld.h>
 #include <libgen.h>
@@ -26,13 +36,124 @@ static std::string getExecutableDir() {
 
 static std::string executableDir = getExecutableDir();
 
-Game::Game() : player(nullptr), currentRegion("Verdant Woods"), shop(nullptr), gameRunning(false) {
-    srand(time(nullptr));
+// All profiles live in one store next to the executable
+static SaveStore& saveStore() {
+    static SaveStore store(executableDir + "/saves.db");
+    return store;
+}
+
+static std::string profileFor(const std::string& name) {
+    std::string profile = name.empty() ? "default" : name;
+    return profile.substr(0, SaveStore::MAX_PROFILE_NAME);
+}
+
+// Each profile autosaves to its own journal; the CRC keeps names that only
+// differ in punctuation apart
+static std::string journalPathFor(const std::string& profile) {
+    std::string safe;
+    for (char c : profile) {
+        safe += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "-%08x", SaveFormat::crc32(profile.data(), profile.size()));
+    return executableDir + "/saves.db." + safe + suffix + ".journal";
+}
+
+// Profiles some Game in this process is playing. A session never replaces
+// or loads a profile another one holds, so no two autosaves share a journal.
+static std::mutex openProfilesMutex;
+static std::set<std::string> openProfiles;
+
+static bool claimProfile(const std::string& profile) {
+    std::lock_guard<std::mutex> lock(openProfilesMutex);
+    return openProfiles.insert(profile).second;
+}
+
+static void releaseProfile(const std::string& profile) {
+    std::lock_guard<std::mutex> lock(openProfilesMutex);
+    openProfiles.erase(profile);
+}
+
+// Bring saves from older versions (savegame.dat / savegame.txt) into an
+// empty store
+static void importLegacySaves(SaveStore& store) {
+    if (!store.isOpen() || store.getProfileCount() > 0) {
+        return;
+    }
+    Player legacy("", PlayerClass::WARRIOR);
+    std::string image;
+    if (AutoSave::recover(executableDir + "/savegame.dat", image)) {
+        SaveFormat::SaveFile save;
+        if (!save.parseBuffer(image.data(), image.size()) || !legacy.readSections(save)) {
+            return;
+        }
+    } else if (legacy.loadFromFile(executableDir + "/savegame.txt")) {
+        SaveFormat::Writer writer;
+        legacy.writeSections(writer);
+        image = writer.finish();
+    } else {
+        return;
+    }
+    if (store.put(profileFor(legacy.getName()), image)) {
+        Console::out() << "Imported old save for " << legacy.getName() << ".\n";
+    }
+}
+
+// World save sections (player sections are written by Player)
+static const uint32_t TAG_WORLD = SaveFormat::makeTag("WRLD");  // current region, looted dungeons
+static const uint32_t TAG_REGION = SaveFormat::makeTag("REGN"); // key: region index
+static const uint32_t TAG_CHUNK = SaveFormat::makeTag("CHNK");  // key: region index << 24 | chunk
+
+static uint32_t chunkKey(uint32_t regionIndex, int chunk) {
+    return regionIndex << 24 | static_cast<uint32_t>(chunk);
+}
+
+// Regions in the order they are travelled, from the start to the final one
+static const char* const REGION_ORDER[] = {
+    "Verdant Woods",
+    "Scorched Dunes",
+    "Frost Peaks",
+    "Dark Citadel"
+};
+static const int REGION_COUNT = sizeof(REGION_ORDER) / sizeof(REGION_ORDER[0]);
+
+// The region a town's travel option leads to, or "" in the last one
+static std::string nextRegion(const std::string& region) {
+    for (int i = 0; i + 1 < REGION_COUNT; i++) {
+        if (region == REGION_ORDER[i]) {
+            return REGION_ORDER[i + 1];
+        }
+    }
+    return "";
+}
+
+static CommandSource& terminalInput() {
+    static TerminalSource terminal;
+    return terminal;
+}
+
+Game::Game() : Game(terminalInput()) {
+}
+
+Game::Game(CommandSource& source)
+    : input(source), player(nullptr), currentRegion("Verdant Woods"), shop(nullptr), autosave(nullptr),
+      profileClaimed(false), gameRunning(false), savingEnabled(true), victory(false), prompt(Prompt::MAIN_MENU), battle(nullptr), battleEnemy(nullptr),
+      battleKind(BattleKind::ENCOUNTER), dungeonBattle(0), dungeonBattles(0), redrawMap(false) {
+    // Seed once per process: games started in the same second (server
+    // sessions) would otherwise keep resetting each other's dice
+    static const bool seeded = (srand(time(nullptr)), true);
+    (void)seeded;
     initializeRegions();
     shop = new Shop("Adventurer's Emporium");
 }
 
 Game::~Game() {
+    delete battle;
+    delete battleEnemy;
+    delete autosave; // drains any queued autosave first
+    if (profileClaimed) {
+        releaseProfile(profileName);
+    }
     delete player;
     delete shop;
     for (auto& pair : regions) {
@@ -42,14 +163,8 @@ Game::~Game() {
 
 void Game::initializeRegions() {
     // Try to load maps from files, or generate defaults
-    std::vector<std::string> regionNames = {
-        "Verdant Woods",
-        "Scorched Dunes",
-        "Frost Peaks",
-        "Dark Citadel"
-    };
-    
-    for (const auto& regionName : regionNames) {
+    for (int i = 0; i < REGION_COUNT; i++) {
+        std::string regionName = REGION_ORDER[i];
         Map* map = new Map();
         // Use executable directory to find maps folder
         std::string filename = executableDir + "/maps/" + regionName + ".txt";
@@ -66,300 +181,686 @@ void Game::initializeRegions() {
 }
 
 void Game::run() {
+    // Nobody is watching a scripted or programmatic session
+    bool animated = input.isInteractive();
+    Colors::setAnimationsEnabled(animated);
+
+    // Each answer is recorded as animation frames and played back here;
+    // typing while it plays skips to the end
+    std::ostream& screen = Console::out();
+    Animation::Recorder recorder;
+    std::ostream recording(&recorder);
+    std::deque<Animation::Frame> frames;
+    std::chrono::steady_clock::time_point typed;
+    std::function<void()> keyShown = [&typed] {
+        Latency::record(Latency::Phase::KEY, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                 std::chrono::steady_clock::now() - typed).count()));
+    };
+    auto show = [&](bool timed) {
+        if (animated) {
+            recorder.take(frames);
+            Animation::play(frames, screen, [this](int ms) { return input.waitForInput(ms); },
+                            timed ? keyShown : nullptr);
+        } else {
+            Latency::Scope timer(Latency::Phase::FLUSH);
+            screen.flush();
+        }
+    };
+    if (animated) {
+        Console::redirect(&recording);
+        Animation::record(&recorder);
+    }
+    // Someone is watching the screen: commands that arrive faster than it
+    // takes frames are answered without drawing the map for each of them
+    if (isatty(STDOUT_FILENO)) {
+        pacer = FramePacer([this] { return input.waitForInput(0); },
+                           [] { return Terminal::outputBehind(STDOUT_FILENO); });
+    }
+
+    start();
+    show(false);
+    std::string line;
+    while (!isFinished()) {
+        // Keystroke sources answer the actions menu and "press Enter" with one key
+        input.expectKeys(prompt == Prompt::COMMAND || prompt == Prompt::INTRO);
+        bool timed = false;
+        if (input.readLine(line)) {
+            timed = input.arrivalTime(typed);
+            feed(line);
+        } else {
+            endOfInput();
+        }
+        show(timed);
+    }
+
+    if (animated) {
+        Animation::record(nullptr);
+        Console::redirect(&screen);
+    }
+}
+
+void Game::start() {
     Colors::printTitle(Colors::colorize("⚔ LEGENDS OF ARKANIA ⚔", Colors::BRIGHT_YELLOW));
-    std::cout << Colors::colorize("🌍 A Turn-Based RPG Adventure in a Fantasy World 🌍", Colors::CYAN) << "\n\n";
-    
+    Console::out() << Colors::colorize("🌍 A Turn-Based RPG Adventure in a Fantasy World 🌍", Colors::CYAN) << "\n\n";
     displayMainMenu();
-    
-    if (!player) {
-        return;
+}
+
+void Game::feed(const std::string& rawLine) {
+    Trace::Span span("Game::feed");
+    Latency::Scope turn(Latency::Phase::TURN);
+    std::string line;
+    {
+        Latency::Scope timer(Latency::Phase::PARSE);
+        line = CommandSource::trim(rawLine);
     }
-    
+    switch (prompt) {
+        case Prompt::MAIN_MENU: onMainMenu(line); break;
+        case Prompt::PROFILE: onProfile(line); break;
+        case Prompt::NAME: onName(line); break;
+        case Prompt::REPLACE: onReplace(line); break;
+        case Prompt::CLASS: onClass(line); break;
+        case Prompt::INTRO: onIntro(); break;
+        case Prompt::COMMAND: onCommand(line); break;
+        case Prompt::USE_ITEM: onUseItem(line); break;
+        case Prompt::SAVE_ON_QUIT: onSaveOnQuit(line); break;
+        case Prompt::TOWN: onTown(line); break;
+        case Prompt::SHOP: onShop(line); break;
+        case Prompt::DUNGEON: onDungeon(line); break;
+        case Prompt::CASTLE: onCastle(line); break;
+        case Prompt::BATTLE: {
+            Latency::Scope timer(Latency::Phase::BATTLE);
+            battle->feed(line);
+            if (battle->isOver()) {
+                onBattleOver();
+            }
+            break;
+        }
+        case Prompt::FINISHED: break;
+    }
+}
+
+// What running out of input means depends on the question being asked
+void Game::endOfInput() {
+    while (prompt != Prompt::FINISHED) {
+        switch (prompt) {
+            case Prompt::MAIN_MENU:
+            case Prompt::PROFILE:
+            case Prompt::NAME:
+            case Prompt::REPLACE:
+            case Prompt::CLASS:
+                finishGame(); // never got into the world
+                break;
+            case Prompt::COMMAND:
+                Console::out() << "\nInput stream closed (EOF). Exiting game.\n";
+                finishGame();
+                break;
+            case Prompt::BATTLE:
+                battle->endOfInput();
+                onBattleOver();
+                break;
+            default:
+                feed(""); // every other prompt treats an empty answer as "no"
+                break;
+        }
+    }
+}
+
+void Game::finishGame() {
+    gameRunning = false;
+    prompt = Prompt::FINISHED;
+    if (player && player->getHealth() <= 0) {
+        static const Ui::Template gameOver(std::string("\n") + Colors::BRIGHT_RED +
+            "╔════════════════════════════════════════╗\n"
+            "║   Game Over! You have been defeated...{@41}║\n"
+            "╚════════════════════════════════════════╝\n" + Colors::RESET);
+        gameOver.render(Console::out());
+    }
+}
+
+// Start playing once a character has been created or loaded
+void Game::enterWorld() {
     gameRunning = true;
     currentRegion = player->getCurrentRegion();
+    // Journals sit beside the store, so without it (another process has
+    // it open) this game leaves them alone too
+    if (savingEnabled && !saveStore().isOpen()) {
+        std::cerr << "Warning: this game will not be saved: " << saveStore().getError() << "\n";
+    } else if (savingEnabled) {
+        autosave = new AutoSave(saveStore(), profileName, journalPathFor(profileName));
+        // Put the profile in the store from the first turn on
+        autosave->submitSnapshot(buildSaveImage());
+    }
     
     // Set initial position if new game
     if (player->getX() == 0 && player->getY() == 0) {
         player->setPosition(1, 1);
     }
     
-    std::cout << "\nYou find yourself in " << currentRegion << "...\n";
+    Console::out() << "\nYou find yourself in " << currentRegion << "...\n";
+    drawMap();
+    showActions();
+}
+
+void Game::drawMap() {
+    Latency::Scope timer(Latency::Phase::RENDER);
     regions[currentRegion]->displayStyled(player->getX(), player->getY(), true);
-    
-    while (gameRunning && player->getHealth() > 0) {
-        // In-Game Menu UI with emojis
-        std::cout << "\n" << Colors::BRIGHT_CYAN;
-        std::cout << "╔══════════════════════════════════════════════════╗\n";
-        std::cout << "║               🎮 ACTIONS 🎮                      ║\n";
-        std::cout << "╠══════════════════════════════════════════════════╣\n";
-        std::cout << "║  " << Colors::YELLOW << "[W/A/S/D]" << Colors::WHITE << " 🚶 Move                            " << Colors::BRIGHT_CYAN << "║\n";
-        std::cout << "║  " << Colors::YELLOW << "[I]      " << Colors::WHITE << " 🎒 Inventory                       " << Colors::BRIGHT_CYAN << "║\n";
-        std::cout << "║  " << Colors::YELLOW << "[P]      " << Colors::WHITE << " 📜 Player Stats                    " << Colors::BRIGHT_CYAN << "║\n";
-        std::cout << "║  " << Colors::YELLOW << "[M]      " << Colors::WHITE << " 🗺️  Map                             " << Colors::BRIGHT_CYAN << "║\n";
-        std::cout << "║  " << Colors::YELLOW << "[H]      " << Colors::WHITE << " ❓ Help                            " << Colors::BRIGHT_CYAN << "║\n";
-        std::cout << "║  " << Colors::BRIGHT_RED << "[Q]      " << Colors::WHITE << " 🚪 Quit                            " << Colors::BRIGHT_CYAN << "║\n";
-        std::cout << "╚══════════════════════════════════════════════════╝\n" << Colors::RESET;
-        
-        std::cout << Colors::BRIGHT_GREEN << "Command: " << Colors::RESET;
-        
-        // Read a full line from input to avoid leftover-newline issues when mixing >> and getline
-        std::string inputLine;
-        std::getline(std::cin, inputLine);
-
-        // If getline fails (EOF or error), handle gracefully
-        if (!std::cin) {
-            if (std::cin.eof()) {
-                std::cout << "\nInput stream closed (EOF). Exiting game.\n";
-                gameRunning = false;
-                break;
-            } else {
-                std::cin.clear();
-                std::cout << "\nInput error detected. Please try again.\n";
-                continue;
-            }
-        }
+}
 
-        // Trim leading spaces
-        size_t pos = inputLine.find_first_not_of(" \t\r\n");
-        if (pos == std::string::npos) {
-            // Empty line — prompt again
-            continue;
+void Game::showActions() {
+    Trace::Span span("Game::showActions");
+    Latency::Scope timer(Latency::Phase::RENDER);
+    // In-Game Menu UI with emojis; nothing in it changes, so it is one block
+    static const Ui::Template menu(std::string("\n") + Colors::BRIGHT_CYAN +
+        "╔══════════════════════════════════════════════════╗\n"
+        "║" + Ui::center("🎮 ACTIONS 🎮", 50).str() + "║\n"
+        "╠══════════════════════════════════════════════════╣\n"
+        "║  " + Colors::YELLOW + "[W/A/S/D]" + Colors::WHITE + " 🚶 Move" + Colors::BRIGHT_CYAN + "{@51}║\n"
+        "║  " + Colors::YELLOW + "[I]      " + Colors::WHITE + " 🎒 Inventory" + Colors::BRIGHT_CYAN + "{@51}║\n"
+        "║  " + Colors::YELLOW + "[P]      " + Colors::WHITE + " 📜 Player Stats" + Colors::BRIGHT_CYAN + "{@51}║\n"
+        "║  " + Colors::YELLOW + "[M]      " + Colors::WHITE + " 🗺️ Map" + Colors::BRIGHT_CYAN + "{@51}║\n"
+        "║  " + Colors::YELLOW + "[O]      " + Colors::WHITE + " 🧭 Region Overview" + Colors::BRIGHT_CYAN + "{@51}║\n"
+        "║  " + Colors::YELLOW + "[H]      " + Colors::WHITE + " ❓ Help" + Colors::BRIGHT_CYAN + "{@51}║\n"
+        "║  " + Colors::BRIGHT_RED + "[Q]      " + Colors::WHITE + " 🚪 Quit" + Colors::BRIGHT_CYAN + "{@51}║\n"
+        "╚══════════════════════════════════════════════════╝\n" + Colors::RESET +
+        Colors::BRIGHT_GREEN + "Command: " + Colors::RESET);
+    menu.render(Console::out());
+    prompt = Prompt::COMMAND;
+}
+
+// A line may pipeline several commands: moves, each optionally counted
+// ("5d"), then at most one other command ("wwwddi"). Fills the moves in
+// order and the final command (0 for none); false if the line is not
+// written that way, when its first letter is the command as before.
+static bool parseBatch(const std::string& line, std::string& moves, char& last) {
+    static const size_t MAX_BATCH_MOVES = 100;
+    moves.clear();
+    last = 0;
+    int count = 0;
+    for (char c : line) {
+        char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        if (last) {
+            return false; // nothing may follow the final command
+        }
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            count = std::min(count * 10 + (c - '0'), static_cast<int>(MAX_BATCH_MOVES));
+        } else if (upper == 'W' || upper == 'A' || upper == 'S' || upper == 'D') {
+            moves.append(count > 0 ? count : 1, upper);
+            count = 0;
+        } else if (!moves.empty() && count == 0 && std::strchr("IPMOHQ", upper)) {
+            last = upper;
+        } else {
+            return false;
+        }
+        if (moves.size() > MAX_BATCH_MOVES) {
+            moves.resize(MAX_BATCH_MOVES);
         }
+    }
+    return !moves.empty() && count == 0;
+}
 
-        char command = std::toupper(static_cast<unsigned char>(inputLine[pos]));
-        
-        switch(command) {
-            case 'W':
-            case 'A':
-            case 'S':
-            case 'D':
-                handleMovement(command);
-                break;
-            case 'I': {
-                player->displayInventory();
-                std::cout << Colors::BRIGHT_YELLOW << "\nUse an item? " << Colors::WHITE << "(enter name or 'no'): " << Colors::RESET;
-                std::string itemName;
-                std::getline(std::cin, itemName);
-                // Trim whitespace
-                size_t start = itemName.find_first_not_of(" \t\r\n");
-                size_t end = itemName.find_last_not_of(" \t\r\n");
-                if (start != std::string::npos) {
-                    itemName = itemName.substr(start, end - start + 1);
-                }
-                if (itemName != "no" && !itemName.empty()) {
-                    player->useItem(itemName);
-                }
-                break;
-            }
-            case 'P':
-                player->displayStats();
-                break;
-            case 'M':
-                regions[currentRegion]->displayStyled(player->getX(), player->getY(), true);
-                break;
-            case 'H':
-                displayHelp();
-                break;
-            case 'Q': {
-                std::cout << "Save game? (y/n): ";
-                std::string _line;
-                std::getline(std::cin, _line);
-                if (!std::cin) {
-                    if (std::cin.eof()) { gameRunning = false; break; }
-                    std::cin.clear();
-                }
-                size_t _p = _line.find_first_not_of(" \t\r\n");
-                char save = (_p == std::string::npos) ? 'n' : std::toupper(static_cast<unsigned char>(_line[_p]));
-                if (save == 'Y') {
-                    saveGame();
+void Game::onCommand(const std::string& line) {
+    if (line.empty()) {
+        // Empty line — prompt again
+        showActions();
+        return;
+    }
+    if (line == "/latency") {
+        // Admin: where this process has been spending its time
+        Latency::report(Console::out());
+        finishCommand();
+        return;
+    }
+
+    std::string moves;
+    char last;
+    if (parseBatch(line, moves, last)) {
+        {
+            // Every step rolls its own encounter; anything that takes over
+            // (a town, a dungeon, a battle) or a wall ends the batch. Only
+            // the last step is announced and the map is drawn once.
+            Latency::Scope timer(Latency::Phase::LOGIC);
+            for (size_t step = 0; step < moves.size() && prompt == Prompt::COMMAND; step++) {
+                if (!handleMovement(moves[step], step + 1 == moves.size())) {
+                    last = 0;
+                    break;
                 }
-                gameRunning = false;
-                break;
             }
-            default:
-                std::cout << "Invalid command.\n";
         }
-        
-        // Passive slow healing (regenerate 1-2% of max HP per turn when not at full health)
-        if (player->getHealth() > 0 && player->getHealth() < player->getMaxHealth()) {
-            int regenAmount = std::max(1, player->getMaxHealth() / 50); // ~2% per turn, minimum 1 HP
-            int oldHealth = player->getHealth();
-            player->heal(regenAmount);
-            if (player->getHealth() > oldHealth) {
-                std::cout << Colors::GREEN << "💚 You recover " << (player->getHealth() - oldHealth) 
-                          << " HP (passive regen). Health: " << player->getHealth() 
-                          << "/" << player->getMaxHealth() << Colors::RESET << "\n";
-            }
+        if (last && prompt == Prompt::COMMAND) {
+            runCommand(last);
         }
+    } else {
+        runCommand(std::toupper(static_cast<unsigned char>(line[0])));
+    }
+    if (prompt == Prompt::COMMAND) {
+        finishCommand();
+    }
+}
 
-        // Check win condition
-        if (currentRegion == "Dark Citadel" && 
-            regions[currentRegion]->getTileAt(player->getX(), player->getY()) == 'C') {
-            std::cout << "\n" << Colors::BRIGHT_GREEN;
-            std::cout << "╔══════════════════════════════════════╗\n";
-            std::cout << "║   " << Colors::BRIGHT_YELLOW << "★ VICTORY! ★" << Colors::BRIGHT_GREEN << "                     ║\n";
-            std::cout << "║   You have conquered the Dark Citadel ║\n";
-            std::cout << "║   Peace has been restored to Arkania! ║\n";
-            std::cout << "╚══════════════════════════════════════╝\n" << Colors::RESET;
-            gameRunning = false;
+// One command from the actions menu. Handlers that need more input move
+// to their own prompt; the command is finished once control is back at
+// COMMAND.
+void Game::runCommand(char command) {
+    switch(command) {
+        case 'W':
+        case 'A':
+        case 'S':
+        case 'D': {
+            Latency::Scope timer(Latency::Phase::LOGIC);
+            handleMovement(command);
+            break;
         }
+        case 'I': {
+            Latency::Scope timer(Latency::Phase::RENDER);
+            player->displayInventory();
+            Console::out() << Colors::BRIGHT_YELLOW << "\nUse or equip an item? " << Colors::WHITE << "(enter name or 'no'): " << Colors::RESET;
+            prompt = Prompt::USE_ITEM;
+            break;
+        }
+        case 'P': {
+            applyRegen();
+            Latency::Scope timer(Latency::Phase::RENDER);
+            player->displayStats();
+            break;
+        }
+        case 'M':
+            drawMap();
+            break;
+        case 'O': {
+            // The whole region at a glance, however large it is
+            Latency::Scope timer(Latency::Phase::RENDER);
+            regions[currentRegion]->displayOverview(player->getX(), player->getY());
+            break;
+        }
+        case 'H':
+            displayHelp();
+            break;
+        case 'Q':
+            Console::out() << "Save game? (y/n): ";
+            prompt = Prompt::SAVE_ON_QUIT;
+            break;
+        default:
+            Console::out() << "Invalid command.\n";
     }
-    
-    if (player->getHealth() <= 0) {
-        std::cout << "\n" << Colors::BRIGHT_RED;
-        std::cout << "╔══════════════════════════════════════╗\n";
-        std::cout << "║   Game Over! You have been defeated...║\n";
-        std::cout << "╚══════════════════════════════════════╝\n" << Colors::RESET;
+}
+
+void Game::onUseItem(const std::string& line) {
+    if (line != "no" && !line.empty()) {
+        player->useItem(line);
     }
+    finishCommand();
 }
 
-void Game::displayMainMenu() {
-    const int width = 50;
-    std::string border;
-    for (int i = 0; i < width - 2; ++i) border += "─";
-    
-    std::cout << "\n" << Colors::BRIGHT_YELLOW;
-    std::cout << "┌" << border << "┐\n";
-    
-    std::string title = " MAIN MENU ";
-    int pad = (width - 2 - title.length()) / 2;
-    std::cout << "│" << std::string(pad, ' ') << Colors::BOLD << title << Colors::RESET << Colors::BRIGHT_YELLOW << std::string(width - 2 - pad - title.length(), ' ') << "│\n";
-    
-    std::cout << "├" << border << "┤\n";
-    std::cout << "│" << std::string(width - 2, ' ') << "│\n"; // spacer
-    
-    // Option 1
-    std::string opt1 = "1. New Game";
-    std::cout << "│  " << Colors::CYAN << Colors::Emoji::SWORD << " " << std::left << std::setw(width - 8) << opt1 << Colors::BRIGHT_YELLOW << "│\n";
-    
-    // Option 2
-    std::string opt2 = "2. Load Game";
-    std::cout << "│  " << Colors::CYAN << Colors::Emoji::SCROLL << " " << std::left << std::setw(width - 8) << opt2 << Colors::BRIGHT_YELLOW << "│\n";
-    
-    // Option 3
-    std::string opt3 = "3. Exit";
-    std::cout << "│  " << Colors::RED << Colors::Emoji::CROSS << " " << std::left << std::setw(width - 8) << opt3 << Colors::BRIGHT_YELLOW << "│\n";
-    
-    std::cout << "│" << std::string(width - 2, ' ') << "│\n"; // spacer
-    std::cout << "└" << border << "┘\n" << Colors::RESET;
-    std::cout << Colors::BRIGHT_GREEN << "Choice: " << Colors::RESET;
+void Game::onSaveOnQuit(const std::string& line) {
+    if (CommandSource::parseChoice(line, 'N') == 'Y') {
+        saveGame();
+    }
+    gameRunning = false;
+    finishCommand();
+}
+
+// A command and everything it led to (town, dungeon, battles) is done
+void Game::finishCommand() {
+    prompt = Prompt::COMMAND;
+    // A skipped frame keeps redrawMap set, so the next one brings it up to date
+    bool draw = pacer.due();
+    if (redrawMap && draw) {
+        // Display map after every move
+        redrawMap = false;
+        drawMap();
+    }
+    endTurn(draw);
+}
+
+void Game::endTurn(bool showMenu) {
+    // Queue a background autosave every few turns
+    if (gameRunning && autosave && autosave->onTurn()) {
+        autosave->submit(buildSaveImage());
+    }
     
-    int choice = 0;
-    {
-        std::string line;
-        std::getline(std::cin, line);
-        if (!std::cin) {
-            if (std::cin.eof()) return;
-            std::cin.clear();
-        }
-
-        // Trim and parse
-        size_t p = line.find_first_not_of(" \t\r\n");
-        if (p != std::string::npos) {
-            try {
-                choice = std::stoi(line.substr(p));
-            } catch (...) {
-                choice = 0;
-            }
+    // Check win condition: the Dark Lord has fallen
+    if (victory) {
+        static const Ui::Template won(std::string("\n") + Colors::BRIGHT_GREEN +
+            "╔════════════════════════════════════════╗\n"
+            "║   " + Colors::BRIGHT_YELLOW + "★ VICTORY! ★" + Colors::BRIGHT_GREEN + "{@41}║\n"
+            "║   You have conquered the Dark Citadel{@41}║\n"
+            "║   Peace has been restored to Arkania!{@41}║\n"
+            "╚════════════════════════════════════════╝\n" + Colors::RESET);
+        won.render(Console::out());
+        gameRunning = false;
+    }
+
+    if (gameRunning && player->getHealth() > 0) {
+        if (showMenu) {
+            showActions();
         }
+    } else {
+        finishGame();
     }
+}
 
-    switch(choice) {
+void Game::displayMainMenu() {
+    static const Ui::Template menu(std::string("\n") + Colors::BRIGHT_YELLOW +
+        "┌────────────────────────────────────────────────┐\n"
+        "│" + Ui::center(std::string(Colors::BOLD) + " MAIN MENU " + Colors::RESET + Colors::BRIGHT_YELLOW, 48).str() + "│\n"
+        "├────────────────────────────────────────────────┤\n"
+        "│{@49}│\n" + // spacer
+        "│  " + Colors::CYAN + Colors::Emoji::SWORD + " 1. New Game" + Colors::BRIGHT_YELLOW + "{@49}│\n" +
+        "│  " + Colors::CYAN + Colors::Emoji::SCROLL + " 2. Load Game" + Colors::BRIGHT_YELLOW + "{@49}│\n" +
+        "│  " + Colors::RED + Colors::Emoji::CROSS + " 3. Exit" + Colors::BRIGHT_YELLOW + "{@49}│\n" +
+        "│{@49}│\n" // spacer
+        "└────────────────────────────────────────────────┘\n" + Colors::RESET +
+        Colors::BRIGHT_GREEN + "Choice: " + Colors::RESET);
+    menu.render(Console::out());
+    prompt = Prompt::MAIN_MENU;
+}
+
+void Game::onMainMenu(const std::string& line) {
+    switch(CommandSource::parseNumber(line, 0)) {
         case 1:
             createNewGame();
             break;
         case 2:
-            if (!loadGame()) {
-                std::cout << "No save file found. Starting new game...\n";
-                createNewGame();
-            }
+            loadGame();
             break;
         case 3:
-            std::cout << "Goodbye!\n";
+            Console::out() << "Goodbye!\n";
+            finishGame();
             break;
         default:
-            std::cout << "Invalid choice. Starting new game...\n";
+            Console::out() << "Invalid choice. Starting new game...\n";
             createNewGame();
     }
 }
 
 void Game::createNewGame() {
     Colors::printTitle(Colors::colorize("⚔ CREATE CHARACTER ⚔", Colors::BRIGHT_YELLOW));
-    std::cout << Colors::CYAN << "👤 Enter your name: " << Colors::WHITE;
-    std::string name;
-    std::cin.ignore();
-    std::getline(std::cin, name);
-    
-    std::cout << "\n" << Colors::BRIGHT_YELLOW << "Choose your class:\n" << Colors::RESET;
-    std::cout << Colors::Emoji::WARRIOR << Colors::WHITE << "1.Warrior " << Colors::DARK_GRAY << "(High HP, High Strength, Low Mana)\n";
-    std::cout << Colors::Emoji::MAGE << " " << Colors::WHITE << "2.Mage " << Colors::DARK_GRAY << "(Low HP, High Mana, Magic Abilities)\n";
-    std::cout << Colors::Emoji::ARCHER << " " << Colors::WHITE << "3.Archer " << Colors::DARK_GRAY << "(Balanced, High Agility)\n";
-    std::cout << Colors::BRIGHT_GREEN << "🎮 Choice: " << Colors::RESET;
-    
-    int classChoice = 0;
-    {
-        std::string line;
-        std::getline(std::cin, line);
-        if (!std::cin) {
-            if (std::cin.eof()) return;
-            std::cin.clear();
-        }
-        size_t p = line.find_first_not_of(" \t\r\n");
-        if (p != std::string::npos) {
-            try {
-                classChoice = std::stoi(line.substr(p));
-            } catch (...) {
-                classChoice = 1; // default to warrior on parse failure
-            }
-        } else {
-            classChoice = 1;
+    Console::out() << Colors::CYAN << "👤 Enter your name: " << Colors::WHITE;
+    prompt = Prompt::NAME;
+}
+
+void Game::onName(const std::string& line) {
+    newName = line;
+    if (savingEnabled && saveStore().isOpen()) {
+        std::string profile = profileFor(newName);
+        if (!claimProfile(profile)) {
+            Console::out() << Colors::YELLOW << "⚠ " << profile
+                      << " is being played in another session. Choose another name.\n" << Colors::RESET;
+            createNewGame();
+            return;
+        }
+        profileName = profile;
+        profileClaimed = true;
+        if (saveStore().contains(profileName) || access(journalPathFor(profileName).c_str(), F_OK) == 0) {
+            Console::out() << Colors::YELLOW << "⚠ There is already a saved game for " << profileName
+                      << ". Replace it? (y/n): " << Colors::RESET;
+            prompt = Prompt::REPLACE;
+            return;
         }
     }
-    
+    chooseClass();
+}
+
+// Only an explicit yes gives up the old save; otherwise pick another name
+void Game::onReplace(const std::string& line) {
+    if (CommandSource::parseChoice(line, 'N') != 'Y') {
+        releaseProfile(profileName);
+        profileClaimed = false;
+        createNewGame();
+        return;
+    }
+    saveStore().remove(profileName);
+    std::remove(journalPathFor(profileName).c_str());
+    chooseClass();
+}
+
+void Game::chooseClass() {
+    Console::out() << "\n" << Colors::BRIGHT_YELLOW << "Choose your class:\n" << Colors::RESET;
+    Console::out() << Colors::Emoji::WARRIOR << Colors::WHITE << "1.Warrior " << Colors::DARK_GRAY << "(High HP, High Strength, Low Mana)\n";
+    Console::out() << Colors::Emoji::MAGE << " " << Colors::WHITE << "2.Mage " << Colors::DARK_GRAY << "(Low HP, High Mana, Magic Abilities)\n";
+    Console::out() << Colors::Emoji::ARCHER << " " << Colors::WHITE << "3.Archer " << Colors::DARK_GRAY << "(Balanced, High Agility)\n";
+    Console::out() << Colors::BRIGHT_GREEN << "🎮 Choice: " << Colors::RESET;
+    prompt = Prompt::CLASS;
+}
+
+void Game::onClass(const std::string& line) {
     PlayerClass pClass;
-    switch(classChoice) {
+    switch(CommandSource::parseNumber(line, 1)) { // default to warrior
         case 1: pClass = PlayerClass::WARRIOR; break;
         case 2: pClass = PlayerClass::MAGE; break;
         case 3: pClass = PlayerClass::ARCHER; break;
         default: pClass = PlayerClass::WARRIOR; break;
     }
-    
-    player = new Player(name, pClass);
+
+    player = new Player(newName, pClass);
     player->setPosition(1, 1);
     player->setRegion("Verdant Woods");
     
     // Play animated intro story
-    Colors::playIntroStory(name, player->getClassName());
-    
-    std::cout << Colors::BRIGHT_GREEN << "\n✨ Welcome, " << Colors::BRIGHT_WHITE << name 
+    Colors::playIntroStory(newName, player->getClassName());
+    prompt = Prompt::INTRO;
+}
+
+void Game::onIntro() {
+    Colors::clearScreen();
+    Console::out() << Colors::BRIGHT_GREEN << "\n✨ Welcome, " << Colors::BRIGHT_WHITE << newName 
               << Colors::BRIGHT_GREEN << " the " << Colors::BRIGHT_YELLOW << player->getClassName() 
               << Colors::BRIGHT_GREEN << "! ✨\n" << Colors::RESET;
     player->displayStats();
+    enterWorld();
 }
 
-bool Game::loadGame() {
-    player = new Player("", PlayerClass::WARRIOR);
-    std::string savePath = executableDir + "/savegame.txt";
-    if (player->loadFromFile(savePath)) {
-        currentRegion = player->getCurrentRegion();
-        std::cout << "\nGame loaded successfully!\n";
-        player->displayStats();
-        return true;
+void Game::loadGame() {
+    profileChoices.clear();
+    if (savingEnabled) {
+        SaveStore& store = saveStore();
+        if (!store.isOpen()) {
+            std::cerr << "Error: save store unavailable: " << store.getError() << "\n";
+        } else {
+            importLegacySaves(store);
+            profileChoices = store.listProfiles();
+        }
     }
-    delete player;
-    player = nullptr;
-    return false;
+
+    if (profileChoices.size() == 1) {
+        loadProfile(profileChoices[0]);
+    } else if (profileChoices.size() > 1) {
+        Console::out() << "\n" << Colors::BRIGHT_YELLOW << "Saved games:\n" << Colors::RESET;
+        for (size_t i = 0; i < profileChoices.size(); i++) {
+            Console::out() << Colors::WHITE << (i + 1) << ". " << profileChoices[i] << "\n";
+        }
+        Console::out() << Colors::BRIGHT_GREEN << "🎮 Load which game? " << Colors::RESET;
+        prompt = Prompt::PROFILE;
+    } else {
+        Console::out() << "No save file found. Starting new game...\n";
+        createNewGame();
+    }
+}
+
+// Pick a profile by number or name
+void Game::onProfile(const std::string& line) {
+    std::string profile;
+    if (std::find(profileChoices.begin(), profileChoices.end(), line) != profileChoices.end()) {
+        profile = line;
+    } else {
+        int choice = CommandSource::parseNumber(line, 0);
+        if (choice >= 1 && static_cast<size_t>(choice) <= profileChoices.size()) {
+            profile = profileChoices[choice - 1];
+        }
+    }
+    profileChoices.clear();
+    if (profile.empty()) {
+        Console::out() << "No save file found. Starting new game...\n";
+        createNewGame();
+        return;
+    }
+    loadProfile(profile);
+}
+
+void Game::loadProfile(const std::string& profile) {
+    Trace::Span span("Game::loadProfile");
+    if (!claimProfile(profile)) {
+        Console::out() << Colors::YELLOW << "⚠ " << profile << " is being played in another session.\n" << Colors::RESET;
+        createNewGame();
+        return;
+    }
+    // Stored snapshot plus any autosave journal written after it
+    std::string image;
+    if (AutoSave::recover(saveStore(), profile, journalPathFor(profile), image)) {
+        player = new Player("", PlayerClass::WARRIOR);
+        SaveFormat::SaveFile save;
+        uint64_t tick = 0;
+        if (save.parseBuffer(image.data(), image.size()) && player->readSections(save, &tick)) {
+            if (tick > clock.now()) {
+                clock.advance(tick - clock.now()); // a loaded game picks up at the saved tick
+            }
+            readWorldSections(save);
+            profileName = profile;
+            profileClaimed = true;
+            Console::out() << "\nGame loaded successfully!\n";
+            player->displayStats();
+            enterWorld();
+            return;
+        }
+        std::cerr << "Error: save for " << profile << " could not be read\n";
+        delete player;
+        player = nullptr;
+    }
+    releaseProfile(profile);
+    Console::out() << "No save file found. Starting new game...\n";
+    createNewGame();
 }
 
 void Game::saveGame() {
-    if (player) {
-        std::string savePath = executableDir + "/savegame.txt";
-        player->saveToFile(savePath);
-        std::cout << "Game saved!\n";
+    Trace::Span span("Game::saveGame");
+    if (player && autosave) {
+        autosave->submitSnapshot(buildSaveImage()); // durable once the game is closed
+        Console::out() << "Game saved!\n";
+    }
+}
+
+// Player plus world state. Only map chunks changed since the previous image
+// are included; the autosave keeps the last saved copy of the rest.
+std::string Game::buildSaveImage() {
+    Trace::Span span("Game::buildSaveImage");
+    // Health in the image includes the regen earned up to now
+    player->regenerate(clock.now());
+    SaveFormat::Writer writer;
+    player->writeSections(writer, clock.now());
+    writeWorldSections(writer);
+    return writer.finish();
+}
+
+void Game::writeWorldSections(SaveFormat::Writer& writer) {
+    writer.beginSection(TAG_WORLD);
+    writer.putString(currentRegion);
+    writer.putU32(static_cast<uint32_t>(clearedDungeons.size()));
+    for (const auto& region : clearedDungeons) {
+        writer.putString(region.first);
+        writer.putU32(static_cast<uint32_t>(region.second.size()));
+        for (const auto& pos : region.second) {
+            writer.putI32(pos.first);
+            writer.putI32(pos.second);
+        }
+    }
+    writer.endSection();
+    
+    uint32_t regionIndex = 0;
+    for (auto& pair : regions) {
+        Map* map = pair.second;
+        writer.beginSection(TAG_REGION, regionIndex);
+        writer.putString(pair.first);
+        writer.putI32(map->getWidth());
+        writer.putI32(map->getHeight());
+        writer.endSection();
+        
+        for (int chunk : map->takeDirtyChunks()) {
+            writer.beginSection(TAG_CHUNK, chunkKey(regionIndex, chunk));
+            map->writeChunk(chunk, writer);
+            writer.endSection();
+        }
+        regionIndex++;
     }
 }
 
-void Game::handleMovement(char direction) {
+bool Game::readWorldSections(const SaveFormat::SaveFile& save) {
+    if (!save.hasSection(TAG_WORLD)) {
+        return false; // older save with player data only
+    }
+    
+    SaveFormat::Reader world(save.getSection(TAG_WORLD));
+    std::string savedRegion = world.getString().str();
+    std::map<std::string, std::set<std::pair<int, int>>> savedDungeons;
+    uint32_t regionCount = world.getU32();
+    for (uint32_t i = 0; i < regionCount && world.ok(); i++) {
+        std::set<std::pair<int, int>>& looted = savedDungeons[world.getString().str()];
+        uint32_t count = world.getU32();
+        for (uint32_t j = 0; j < count && world.ok(); j++) {
+            int dx = world.getI32();
+            int dy = world.getI32();
+            looted.insert(std::make_pair(dx, dy));
+        }
+    }
+    if (!world.ok()) {
+        return false;
+    }
+    if (regions.count(savedRegion)) {
+        currentRegion = savedRegion;
+    }
+    clearedDungeons.swap(savedDungeons);
+    
+    // One pass over the section table: region headers first, then chunks
+    std::map<uint32_t, Map*> savedRegions;
+    for (const auto& section : save.getSections()) {
+        if (section.tag != TAG_REGION) continue;
+        SaveFormat::Reader header(section.payload);
+        std::string name = header.getString().str();
+        int savedWidth = header.getI32();
+        int savedHeight = header.getI32();
+        auto it = regions.find(name);
+        if (!header.ok() || it == regions.end() || savedWidth <= 0 || savedHeight <= 0) {
+            continue;
+        }
+        it->second->resize(name, savedWidth, savedHeight);
+        it->second->takeDirtyChunks();
+        savedRegions[section.key] = it->second;
+    }
+    
+    std::map<Map*, std::vector<char>> restored;
+    for (const auto& section : save.getSections()) {
+        if (section.tag != TAG_CHUNK) continue;
+        auto it = savedRegions.find(section.key >> 24);
+        int chunk = static_cast<int>(section.key & 0xFFFFFF);
+        if (it != savedRegions.end() && it->second->readChunk(chunk, section.payload)) {
+            std::vector<char>& seen = restored[it->second];
+            seen.resize(it->second->getChunkCount(), 0);
+            seen[chunk] = 1;
+        }
+    }
+    
+    // Anything the save didn't cover still has to go out with the next save
+    for (const auto& pair : savedRegions) {
+        std::vector<char>& seen = restored[pair.second];
+        seen.resize(pair.second->getChunkCount(), 0);
+        for (int i = 0; i < pair.second->getChunkCount(); i++) {
+            if (!seen[i]) pair.second->markChunkDirty(i);
+        }
+    }
+    return true;
+}
+
+// Passive healing is settled only when health is about to matter, from
+// however many ticks have passed since it was last settled
+void Game::applyRegen() {
+    int recovered = player->regenerate(clock.now());
+    if (recovered > 0) {
+        Console::out() << Colors::GREEN << "💚 You recover " << recovered
+                  << " HP (passive regen). Health: " << player->getHealth()
+                  << "/" << player->getMaxHealth() << Colors::RESET << "\n";
+    }
+}
+
+bool Game::handleMovement(char direction, bool announce) {
     int newX = player->getX();
     int newY = player->getY();
     
@@ -374,10 +875,13 @@ void Game::handleMovement(char direction) {
     
     if (currentMap->canMoveTo(newX, newY)) {
         player->setPosition(newX, newY);
+        clock.advance(WorldClock::TICKS_PER_MOVE);
         char tile = currentMap->getTileAt(newX, newY);
         
-        std::cout << "\n" << Colors::BRIGHT_GREEN << "💫 ";
-        std::cout << "You move to " << currentMap->getTileDescription(tile) << ".\n" << Colors::RESET;
+        if (announce) {
+            Console::out() << "\n" << Colors::BRIGHT_GREEN << "💫 ";
+            Console::out() << "You move to " << currentMap->getTileDescription(tile) << ".\n" << Colors::RESET;
+        }
         
         // Handle special tiles
         if (tile == 'T') {
@@ -393,28 +897,63 @@ void Game::handleMovement(char direction) {
             }
         }
         
-        // Display map after every move
-    currentMap->displayStyled(newX, newY, true);
-    } else {
-        std::cout << Colors::BRIGHT_RED << "❌ You can't move there!\n" << Colors::RESET;
+        // Map is shown once whatever this tile started is over
+        redrawMap = true;
+        return true;
     }
+    Console::out() << Colors::BRIGHT_RED << "❌ You can't move there!\n" << Colors::RESET;
+    return false;
 }
 
 void Game::handleRandomEncounter() {
-    Enemy* enemy = generateRandomEnemy();
-    Battle battle(player, enemy);
-    bool playerWon = battle.start();
-    delete enemy;
-    
-    if (!playerWon) {
-        // Player lost - restore some health and continue
-        player->heal(player->getMaxHealth() / 2);
-        std::cout << "You wake up at the edge of the region, weakened but alive...\n";
-        player->setPosition(1, 1);
+    startBattle(generateRandomEnemy(), BattleKind::ENCOUNTER);
+}
+
+void Game::startBattle(Enemy* enemy, BattleKind kind) {
+    applyRegen(); // fight with what the walk here restored
+    battleEnemy = enemy;
+    battleKind = kind;
+    battle = new Battle(player, enemy);
+    battle->begin();
+    prompt = Prompt::BATTLE;
+}
+
+void Game::onBattleOver() {
+    bool won = battle->playerWon();
+    delete battle;
+    delete battleEnemy;
+    battle = nullptr;
+    battleEnemy = nullptr;
+
+    switch (battleKind) {
+        case BattleKind::ENCOUNTER:
+            if (!won) {
+                // Player lost - restore some health and continue
+                player->heal(player->getMaxHealth() / 2);
+                Console::out() << "You wake up at the edge of the region, weakened but alive...\n";
+                player->setPosition(1, 1);
+            }
+            break;
+        case BattleKind::DUNGEON:
+            if (!won) {
+                Console::out() << Colors::BRIGHT_RED << "You retreat from the dungeon...\n" << Colors::RESET;
+                break;
+            }
+            if (++dungeonBattle < dungeonBattles) {
+                startDungeonBattle();
+                return;
+            }
+            claimDungeonTreasure();
+            break;
+        case BattleKind::FINAL_BOSS:
+            victory = won;
+            break;
     }
+    finishCommand();
 }
 
 Enemy* Game::generateRandomEnemy() {
+    Trace::Span span("Game::generateRandomEnemy");
     std::vector<std::string> enemyNames;
     int enemyLevel = player->getLevel() + (rand() % 3) - 1; // ±1 level variation
     enemyLevel = std::max(1, enemyLevel);
@@ -437,177 +976,343 @@ Enemy* Game::generateRandomEnemy() {
 }
 
 void Game::handleTownInteraction() {
-    std::cout << "\n" << Colors::BRIGHT_CYAN;
-    std::cout << "╔════════════════════════════════════════════════╗\n";
-    std::cout << "║           🏘️  WELCOME TO TOWN 🏘️               ║\n";
-    std::cout << "╠════════════════════════════════════════════════╣\n";
-    std::cout << "║  " << Colors::YELLOW << "1." << Colors::WHITE << " 🛒 Visit Shop                            " << Colors::BRIGHT_CYAN << "║\n";
-    std::cout << "║  " << Colors::YELLOW << "2." << Colors::WHITE << " 🛏️  Rest at Inn (Restore HP/MP)          " << Colors::BRIGHT_CYAN << "║\n";
-    std::cout << "║  " << Colors::YELLOW << "3." << Colors::WHITE << " 🚪 Leave Town                            " << Colors::BRIGHT_CYAN << "║\n";
-    std::cout << "╚════════════════════════════════════════════════╝\n" << Colors::RESET;
-    std::cout << Colors::BRIGHT_GREEN << "🎮 Choice: " << Colors::RESET;
-    
-    int choice = 0;
-    {
-        std::string line;
-        std::getline(std::cin, line);
-        if (!std::cin) {
-            if (std::cin.eof()) return;
-            std::cin.clear();
-        }
-        size_t p = line.find_first_not_of(" \t\r\n");
-        if (p != std::string::npos) {
-            try { choice = std::stoi(line.substr(p)); } catch (...) { choice = 3; }
-        } else { choice = 3; }
+    static const Ui::Template menu(std::string("\n") + Colors::BRIGHT_CYAN +
+        "╔════════════════════════════════════════════════╗\n"
+        "║" + Ui::center("🏘️ WELCOME TO TOWN 🏘️", 48).str() + "║\n"
+        "╠════════════════════════════════════════════════╣\n"
+        "║  " + Colors::YELLOW + "1." + Colors::WHITE + " 🛒 Visit Shop" + Colors::BRIGHT_CYAN + "{@49}║\n" +
+        "║  " + Colors::YELLOW + "2." + Colors::WHITE + " 🛏️ Rest at Inn (Restore HP/MP)" + Colors::BRIGHT_CYAN + "{@49}║\n" +
+        "║  " + Colors::YELLOW + "3." + Colors::WHITE + " 🚪 Leave Town" + Colors::BRIGHT_CYAN + "{@49}║\n");
+    static const Ui::Template travel(std::string("║  ") + Colors::YELLOW + "4." + Colors::WHITE + " 🧭 Travel to {}" +
+        Colors::BRIGHT_CYAN + "{@49}║\n");
+    static const Ui::Template footer(std::string("╚════════════════════════════════════════════════╝\n") + Colors::RESET +
+        Colors::BRIGHT_GREEN + "🎮 Choice: " + Colors::RESET);
+
+    menu.render(Console::out());
+    std::string next = nextRegion(currentRegion);
+    if (!next.empty()) {
+        travel.render(Console::out(), {next});
     }
+    footer.render(Console::out());
+    
+    prompt = Prompt::TOWN;
+}
 
+void Game::onTown(const std::string& line) {
+    Latency::Scope timer(Latency::Phase::LOGIC);
+    std::string next = nextRegion(currentRegion);
+    int choice = CommandSource::parseNumber(line, 3);
+    if (choice == 4 && next.empty()) {
+        choice = 3; // nowhere further to travel
+    }
     switch(choice) {
-        case 1: {
+        case 1:
             shop->displayShop(player);
-            std::cout << Colors::BRIGHT_YELLOW << "Enter item name to buy " << Colors::WHITE << "(or 'leave'): " << Colors::RESET;
-            std::string itemName;
-            std::getline(std::cin, itemName);
-            // Trim
-            size_t start = itemName.find_first_not_of(" \t\r\n");
-            size_t end = itemName.find_last_not_of(" \t\r\n");
-            if (start != std::string::npos) {
-                itemName = itemName.substr(start, end - start + 1);
-            }
-            if (itemName != "leave" && !itemName.empty()) {
-                shop->buyItem(player, itemName);
-            }
-            break;
-        }
+            Console::out() << Colors::BRIGHT_YELLOW << "Enter item name to buy " << Colors::WHITE << "(or 'leave'): " << Colors::RESET;
+            prompt = Prompt::SHOP;
+            return;
         case 2:
             player->heal(player->getMaxHealth());
             player->restoreMana(player->getMaxMana());
             Colors::animateLoading("Resting at the inn", 1000);
-            std::cout << Colors::BRIGHT_GREEN << "💤 You rest at the inn and restore all health and mana!\n" << Colors::RESET;
+            Console::out() << Colors::BRIGHT_GREEN << "💤 You rest at the inn and restore all health and mana!\n" << Colors::RESET;
+            break;
+        case 4:
+            travelTo(next);
             break;
         case 3:
         default:
-            std::cout << Colors::CYAN << "👋 You leave the town.\n" << Colors::RESET;
+            Console::out() << Colors::CYAN << "👋 You leave the town.\n" << Colors::RESET;
             break;
     }
+    finishCommand();
+}
+
+// Roads from town lead on to the next region, arriving at its corner
+void Game::travelTo(const std::string& region) {
+    currentRegion = region;
+    player->setRegion(region);
+    player->setPosition(1, 1);
+    Colors::animateLoading("Travelling", 1000);
+    Console::out() << Colors::BRIGHT_CYAN << "🧭 You travel to " << region << ".\n" << Colors::RESET;
+    redrawMap = true;
+}
+
+void Game::onShop(const std::string& line) {
+    Latency::Scope timer(Latency::Phase::LOGIC);
+    if (line != "leave" && !line.empty()) {
+        shop->buyItem(player, line);
+    }
+    finishCommand();
 }
 
 void Game::handleDungeon() {
-    std::cout << "\n" << Colors::BRIGHT_MAGENTA;
-    std::cout << "╔════════════════════════════════════════════════╗\n";
-    std::cout << "║            🕳️  DUNGEON ENTRANCE 🕳️             ║\n";
-    std::cout << "╠════════════════════════════════════════════════╣\n";
-    std::cout << "║  " << Colors::WHITE << "A dark dungeon entrance looms before you..." << Colors::BRIGHT_MAGENTA << "  ║\n";
-    std::cout << "║  " << Colors::YELLOW << "⚠️  Warning: Multiple battles await inside!" << Colors::BRIGHT_MAGENTA << "   ║\n";
-    std::cout << "╚════════════════════════════════════════════════╝\n" << Colors::RESET;
-    std::cout << Colors::BRIGHT_YELLOW << "🚪 Enter the dungeon? " << Colors::WHITE << "(y/n): " << Colors::RESET;
-    {
-        std::string line;
-        std::getline(std::cin, line);
-        if (!std::cin) {
-            if (std::cin.eof()) return;
-            std::cin.clear();
-        }
-        size_t p = line.find_first_not_of(" \t\r\n");
-        char choice = (p == std::string::npos) ? 'n' : std::toupper(static_cast<unsigned char>(line[p]));
-        if (choice == 'Y') {
-            std::cout << Colors::BRIGHT_MAGENTA << "\nYou venture into the darkness...\n\n" << Colors::RESET;
-            // Multiple battles in dungeon
-            int battles = 2 + (rand() % 3);
-            for (int i = 0; i < battles; i++) {
-                std::cout << Colors::BRIGHT_CYAN << "--- Battle " << (i + 1) << " of " << battles << " ---\n" << Colors::RESET;
-                Enemy* enemy = generateRandomEnemy();
-                Battle battle(player, enemy);
-                bool won = battle.start();
-                delete enemy;
-                
-                if (!won) {
-                    std::cout << Colors::BRIGHT_RED << "You retreat from the dungeon...\n" << Colors::RESET;
-                    return;
-                }
-            }
-            
-            // Dungeon reward
-            int goldReward = 100 + (rand() % 100);
-            player->addGold(goldReward);
-            std::cout << "\n" << Colors::BRIGHT_YELLOW;
-            std::cout << "╔════════════════════════════════════════════════╗\n";
-            std::cout << "║           💎 TREASURE FOUND! 💎                ║\n";
-            std::cout << "╚════════════════════════════════════════════════╝\n" << Colors::RESET;
-            std::cout << Colors::BRIGHT_GREEN << "💰 You found " << goldReward << " gold in a treasure chest!\n" << Colors::RESET;
-        }
+    static const Ui::Template entrance(std::string("\n") + Colors::BRIGHT_MAGENTA +
+        "╔════════════════════════════════════════════════╗\n"
+        "║" + Ui::center("🕳️ DUNGEON ENTRANCE 🕳️", 48).str() + "║\n"
+        "╠════════════════════════════════════════════════╣\n"
+        "║  " + Colors::WHITE + "A dark dungeon entrance looms before you..." + Colors::BRIGHT_MAGENTA + "{@49}║\n" +
+        "║  " + Colors::YELLOW + "⚠️ Warning: Multiple battles await inside!" + Colors::BRIGHT_MAGENTA + "{@49}║\n" +
+        "╚════════════════════════════════════════════════╝\n" + Colors::RESET +
+        Colors::BRIGHT_YELLOW + "🚪 Enter the dungeon? " + Colors::WHITE + "(y/n): " + Colors::RESET);
+    entrance.render(Console::out());
+    prompt = Prompt::DUNGEON;
+}
+
+void Game::onDungeon(const std::string& line) {
+    Latency::Scope timer(Latency::Phase::LOGIC);
+    if (CommandSource::parseChoice(line, 'N') != 'Y') {
+        finishCommand();
+        return;
     }
+    Console::out() << Colors::BRIGHT_MAGENTA << "\nYou venture into the darkness...\n\n" << Colors::RESET;
+    // Multiple battles in dungeon
+    dungeonBattle = 0;
+    dungeonBattles = 2 + (rand() % 3);
+    startDungeonBattle();
+}
+
+void Game::startDungeonBattle() {
+    Console::out() << Colors::BRIGHT_CYAN << "--- Battle " << (dungeonBattle + 1) << " of " << dungeonBattles << " ---\n" << Colors::RESET;
+    startBattle(generateRandomEnemy(), BattleKind::DUNGEON);
+}
+
+// Each dungeon's treasure can only be looted once
+void Game::claimDungeonTreasure() {
+    std::pair<int, int> dungeonPos(player->getX(), player->getY());
+    if (clearedDungeons[currentRegion].count(dungeonPos)) {
+        Console::out() << Colors::GRAY << "\nThe treasure chest lies open and empty - this dungeon was already looted.\n" << Colors::RESET;
+        return;
+    }
+    clearedDungeons[currentRegion].insert(dungeonPos);
+    
+    // Dungeon reward
+    int goldReward = 100 + (rand() % 100);
+    player->addGold(goldReward);
+    static const Ui::Template treasure(std::string("\n") + Colors::BRIGHT_YELLOW +
+        "╔════════════════════════════════════════════════╗\n"
+        "║" + Ui::center("💎 TREASURE FOUND! 💎", 48).str() + "║\n"
+        "╚════════════════════════════════════════════════╝\n" + Colors::RESET);
+    treasure.render(Console::out());
+    Console::out() << Colors::BRIGHT_GREEN << "💰 You found " << goldReward << " gold in a treasure chest!\n" << Colors::RESET;
 }
 
 void Game::handleCastle() {
     if (currentRegion == "Dark Citadel") {
-        std::cout << "\n" << Colors::BRIGHT_RED;
-        std::cout << "╔════════════════════════════════════════════════╗\n";
-        std::cout << "║          🏰 THE DARK CITADEL 🏰                ║\n";
-        std::cout << "╠════════════════════════════════════════════════╣\n";
-        std::cout << "║  " << Colors::WHITE << "⚔️  The Dark Lord awaits within..." << Colors::BRIGHT_RED << "           ║\n";
-        std::cout << "║  " << Colors::YELLOW << "💀 This is the FINAL BATTLE!" << Colors::BRIGHT_RED << "                 ║\n";
-        std::cout << "╚════════════════════════════════════════════════╝\n" << Colors::RESET;
+        static const Ui::Template citadel(std::string("\n") + Colors::BRIGHT_RED +
+            "╔════════════════════════════════════════════════╗\n"
+            "║" + Ui::center("🏰 THE DARK CITADEL 🏰", 48).str() + "║\n"
+            "╠════════════════════════════════════════════════╣\n"
+            "║  " + Colors::WHITE + "⚔️ The Dark Lord awaits within..." + Colors::BRIGHT_RED + "{@49}║\n" +
+            "║  " + Colors::YELLOW + "💀 This is the FINAL BATTLE!" + Colors::BRIGHT_RED + "{@49}║\n" +
+            "╚════════════════════════════════════════════════╝\n" + Colors::RESET);
+        citadel.render(Console::out());
         Colors::typewriter("Do you dare enter and face your destiny? ", 30);
-        std::cout << Colors::WHITE << "(y/n): " << Colors::RESET;
-        {
-            std::string line;
-            std::getline(std::cin, line);
-            if (!std::cin) {
-                if (std::cin.eof()) return;
-                std::cin.clear();
+        Console::out() << Colors::WHITE << "(y/n): " << Colors::RESET;
+        prompt = Prompt::CASTLE;
+    } else {
+        static const Ui::Template castle(std::string("\n") + Colors::BRIGHT_CYAN +
+            "╔════════════════════════════════════════════════╗\n"
+            "║" + Ui::center("🏰 CASTLE 🏰", 48).str() + "║\n"
+            "╚════════════════════════════════════════════════╝\n" + Colors::RESET);
+        castle.render(Console::out());
+        Console::out() << Colors::WHITE << "A grand castle stands before you, but it's locked.\n" << Colors::RESET;
+    }
+}
+
+void Game::onCastle(const std::string& line) {
+    Latency::Scope timer(Latency::Phase::LOGIC);
+    if (CommandSource::parseChoice(line, 'N') == 'Y') {
+        startBattle(new Enemy("Dark Lord", player->getLevel() + 5, currentRegion), BattleKind::FINAL_BOSS);
+        return;
+    }
+    finishCommand();
+}
+
+void Game::observe(Observation& observation, int windowRadius) const {
+    observation = Observation();
+    observation.prompt = static_cast<int>(prompt);
+    observation.finished = isFinished();
+    observation.victory = victory;
+    observation.region = currentRegion;
+    legalActions(observation.legalActions);
+    if (!player) {
+        return;
+    }
+
+    observation.hasPlayer = true;
+    observation.x = player->getX();
+    observation.y = player->getY();
+    observation.level = player->getLevel();
+    observation.experience = player->getExperience();
+    observation.health = player->healthAt(clock.now()); // as it stands now, regen included
+    observation.maxHealth = player->getMaxHealth();
+    observation.mana = player->getMana();
+    observation.maxMana = player->getMaxMana();
+    observation.gold = player->getGold();
+    observation.attackPower = player->getAttackPower();
+    observation.defensePower = player->getDefensePower();
+    for (const Item& item : player->getInventory()) {
+        if (item.type == "potion" && item.name.find("Health") != std::string::npos) {
+            observation.potions++;
+        }
+    }
+
+    auto found = regions.find(currentRegion);
+    if (found != regions.end()) {
+        const Map* map = found->second;
+        observation.windowRadius = windowRadius;
+        for (int dy = -windowRadius; dy <= windowRadius; dy++) {
+            std::string row;
+            for (int dx = -windowRadius; dx <= windowRadius; dx++) {
+                int tx = observation.x + dx;
+                int ty = observation.y + dy;
+                row += map->isValidPosition(tx, ty) ? map->getTileAt(tx, ty) : ' ';
             }
-            size_t p = line.find_first_not_of(" \t\r\n");
-            char choice = (p == std::string::npos) ? 'n' : std::toupper(static_cast<unsigned char>(line[p]));
-            if (choice == 'Y') {
-                Enemy* finalBoss = new Enemy("Dark Lord", player->getLevel() + 5, currentRegion);
-                Battle battle(player, finalBoss);
-                battle.start();
-                delete finalBoss;
+            observation.mapWindow.push_back(row);
+        }
+    }
+
+    if (battle && battleEnemy) {
+        observation.inBattle = true;
+        observation.battlePrompt = static_cast<int>(battle->getPrompt());
+        observation.enemyName = battleEnemy->getName();
+        observation.enemyLevel = battleEnemy->getLevel();
+        observation.enemyHealth = battleEnemy->getHealth();
+        observation.enemyMaxHealth = battleEnemy->getMaxHealth();
+    }
+}
+
+void Game::legalActions(std::vector<std::string>& actions) const {
+    actions.clear();
+    switch (prompt) {
+        case Prompt::MAIN_MENU:
+        case Prompt::CLASS:
+            actions = {"1", "2", "3"};
+            break;
+        case Prompt::PROFILE:
+            for (size_t i = 0; i < profileChoices.size(); i++) {
+                actions.push_back(std::to_string(i + 1));
+            }
+            break;
+        case Prompt::NAME:
+            actions.push_back("Hero");
+            break;
+        case Prompt::INTRO:
+            actions.push_back("");
+            break;
+        case Prompt::COMMAND: {
+            const Map* map = regions.find(currentRegion)->second;
+            int x = player->getX();
+            int y = player->getY();
+            if (map->canMoveTo(x, y - 1)) actions.push_back("W");
+            if (map->canMoveTo(x - 1, y)) actions.push_back("A");
+            if (map->canMoveTo(x, y + 1)) actions.push_back("S");
+            if (map->canMoveTo(x + 1, y)) actions.push_back("D");
+            for (const char* command : {"I", "P", "M", "O", "H", "Q"}) {
+                actions.push_back(command);
             }
+            break;
         }
-    } else {
-        std::cout << "\n" << Colors::BRIGHT_CYAN;
-        std::cout << "╔════════════════════════════════════════════════╗\n";
-        std::cout << "║               🏰 CASTLE 🏰                     ║\n";
-        std::cout << "╚════════════════════════════════════════════════╝\n" << Colors::RESET;
-        std::cout << Colors::WHITE << "A grand castle stands before you, but it's locked.\n" << Colors::RESET;
+        case Prompt::USE_ITEM:
+            actions.push_back("no");
+            for (const Item& item : player->getInventory()) {
+                if (std::find(actions.begin(), actions.end(), item.name) == actions.end()) {
+                    actions.push_back(item.name);
+                }
+            }
+            break;
+        case Prompt::REPLACE:
+        case Prompt::SAVE_ON_QUIT:
+        case Prompt::DUNGEON:
+        case Prompt::CASTLE:
+            actions = {"y", "n"};
+            break;
+        case Prompt::TOWN:
+            actions = {"1", "2", "3"};
+            if (!nextRegion(currentRegion).empty()) {
+                actions.push_back("4");
+            }
+            break;
+        case Prompt::SHOP:
+            actions.push_back("leave");
+            for (const Item& item : shop->getItems()) {
+                if (item.price <= player->getGold()) {
+                    actions.push_back(item.name);
+                }
+            }
+            break;
+        case Prompt::BATTLE:
+            switch (battle->getPrompt()) {
+                case Battle::Prompt::ACTION:
+                    actions = {"1", "3", "4"};
+                    if (!player->getSkills().empty()) {
+                        actions.insert(actions.begin() + 1, "2");
+                    }
+                    break;
+                case Battle::Prompt::SKILL: {
+                    actions.push_back("0");
+                    const auto& skills = player->getSkills();
+                    for (size_t i = 0; i < skills.size(); i++) {
+                        if (skills[i].manaCost <= player->getMana()) {
+                            actions.push_back(std::to_string(i + 1));
+                        }
+                    }
+                    break;
+                }
+                case Battle::Prompt::ITEM:
+                    actions.push_back("cancel");
+                    for (const Item& item : player->getInventory()) {
+                        if (item.type == "potion" &&
+                            std::find(actions.begin(), actions.end(), item.name) == actions.end()) {
+                            actions.push_back(item.name);
+                        }
+                    }
+                    break;
+                case Battle::Prompt::OVER:
+                    break;
+            }
+            break;
+        case Prompt::FINISHED:
+            break;
     }
 }
 
 void Game::displayHelp() {
-    std::cout << "\n" << Colors::BRIGHT_YELLOW;
-    std::cout << "╔══════════════════════════════════════════════════╗\n";
-    std::cout << "║                  ❓ HELP ❓                       ║\n";
-    std::cout << "╠══════════════════════════════════════════════════╣\n" << Colors::RESET;
-    
-    std::cout << Colors::BRIGHT_YELLOW << "║ " << Colors::BRIGHT_CYAN << "🚶 MOVEMENT:" << std::string(36, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::WHITE << "W - ⬆️  North    S - ⬇️  South" << std::string(13, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::WHITE << "A - ⬅️  West     D - ➡️  East" << std::string(13, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    
-    std::cout << Colors::BRIGHT_YELLOW << "╠──────────────────────────────────────────────────╣\n";
-    
-    std::cout << Colors::BRIGHT_YELLOW << "║ " << Colors::BRIGHT_CYAN << "🗺️  MAP TILES:" << std::string(34, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::GREEN << "🌿 Grass" << Colors::WHITE << " - Safe terrain" << std::string(19, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::BRIGHT_YELLOW << "🏘️  Town" << Colors::WHITE << "  - Shop & rest" << std::string(19, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::GREEN << "🌲 Forest" << Colors::WHITE << "- May encounter enemies" << std::string(12, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::MAGENTA << "🕳️  Dungeon" << Colors::WHITE << " - Multiple battles" << std::string(13, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::BRIGHT_RED << "🏰 Castle" << Colors::WHITE << " - Final boss location" << std::string(11, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::BRIGHT_WHITE << "🧱 Wall" << Colors::WHITE << "   - Cannot pass" << std::string(19, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    
-    std::cout << Colors::BRIGHT_YELLOW << "╠──────────────────────────────────────────────────╣\n";
-    
-    std::cout << Colors::BRIGHT_YELLOW << "║ " << Colors::BRIGHT_CYAN << "⚔️  COMBAT:" << std::string(37, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::WHITE << "1 - ⚔️  Attack (deal damage)" << std::string(15, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::WHITE << "2 - ✨ Skills (special abilities)" << std::string(10, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::WHITE << "3 - 🛡️  Defend (reduce damage)" << std::string(12, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::WHITE << "4 - 🧪 Item (use potions)" << std::string(18, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    
-    std::cout << Colors::BRIGHT_YELLOW << "╠──────────────────────────────────────────────────╣\n";
-    
-    std::cout << Colors::BRIGHT_YELLOW << "║ " << Colors::BRIGHT_CYAN << "🎯 GOAL:" << std::string(40, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::WHITE << "Explore regions, level up, and defeat" << std::string(7, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    std::cout << Colors::BRIGHT_YELLOW << "║   " << Colors::WHITE << "the Dark Lord in the Dark Citadel!" << std::string(10, ' ') << Colors::BRIGHT_YELLOW << "║\n";
-    
-    std::cout << Colors::BRIGHT_YELLOW << "╚══════════════════════════════════════════════════╝\n" << Colors::RESET;
+    static const Ui::Template help(std::string("\n") + Colors::BRIGHT_YELLOW +
+        "╔══════════════════════════════════════════════════╗\n"
+        "║" + Ui::center("❓ HELP ❓", 50).str() + "║\n"
+        "╠══════════════════════════════════════════════════╣\n" + Colors::RESET +
+
+        Colors::BRIGHT_YELLOW + "║ " + Colors::BRIGHT_CYAN + "🚶 MOVEMENT:" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::WHITE + "W - ⬆️ North{@19}S - ⬇️ South" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::WHITE + "A - ⬅️ West{@19}D - ➡️ East" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+
+        Colors::BRIGHT_YELLOW + "╠──────────────────────────────────────────────────╣\n" +
+
+        Colors::BRIGHT_YELLOW + "║ " + Colors::BRIGHT_CYAN + "🗺️ MAP TILES:" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::GREEN + "🌿 Grass" + Colors::WHITE + "{@15}- Safe terrain" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::BRIGHT_YELLOW + "🏘️ Town" + Colors::WHITE + "{@15}- Shop & rest" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::GREEN + "🌲 Forest" + Colors::WHITE + "{@15}- May encounter enemies" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::MAGENTA + "🕳️ Dungeon" + Colors::WHITE + "{@15}- Multiple battles" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::BRIGHT_RED + "🏰 Castle" + Colors::WHITE + "{@15}- Final boss location" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::BRIGHT_WHITE + "🧱 Wall" + Colors::WHITE + "{@15}- Cannot pass" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+
+        Colors::BRIGHT_YELLOW + "╠──────────────────────────────────────────────────╣\n" +
+
+        Colors::BRIGHT_YELLOW + "║ " + Colors::BRIGHT_CYAN + "⚔️ COMBAT:" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::WHITE + "1 - ⚔️ Attack (deal damage)" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::WHITE + "2 - ✨ Skills (special abilities)" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::WHITE + "3 - 🛡️ Defend (reduce damage)" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::WHITE + "4 - 🧪 Item (use potions)" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+
+        Colors::BRIGHT_YELLOW + "╠──────────────────────────────────────────────────╣\n" +
+
+        Colors::BRIGHT_YELLOW + "║ " + Colors::BRIGHT_CYAN + "🎯 GOAL:" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::WHITE + "Explore regions, level up, and defeat" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+        Colors::BRIGHT_YELLOW + "║   " + Colors::WHITE + "the Dark Lord in the Dark Citadel!" + Colors::BRIGHT_YELLOW + "{@51}║\n" +
+
+        Colors::BRIGHT_YELLOW + "╚══════════════════════════════════════════════════╝\n" + Colors::RESET);
+    help.render(Console::out());
 }
 
@@ -6,35 +6,151 @@
 #include "Battle.h"
 #include "Shop.h"
 #include "Enemy.h"
+#include "AutoSave.h"
+#include "CommandSource.h"
+#include "WorldClock.h"
+#include "FramePacer.h"
+#include "Observation.h"
 #include <map>
+#include <set>
 #include <string>
+#include <vector>
 
+// The game is a state machine over the question it is waiting on: feed()
+// answers the current prompt with one line of input, runs everything that
+// follows from it and stops at the next prompt. Nothing blocks, so a
+// session can be driven by run() reading its CommandSource or by a caller
+// that receives lines some other way (see Server).
 class Game {
+public:
+    enum class Prompt {
+        MAIN_MENU,
+        PROFILE,       // which saved game to load
+        NAME,
+        REPLACE,       // overwrite the saved game of that name? (y/n)
+        CLASS,
+        INTRO,         // "press Enter" after the intro story
+        COMMAND,       // the in-world actions menu
+        USE_ITEM,
+        SAVE_ON_QUIT,
+        TOWN,
+        SHOP,
+        DUNGEON,       // enter? (y/n)
+        CASTLE,        // face the Dark Lord? (y/n)
+        BATTLE,        // answered by the current Battle
+        FINISHED
+    };
+
 private:
+    enum class BattleKind { ENCOUNTER, DUNGEON, FINAL_BOSS };
+
+    CommandSource& input;
     Player* player;
     std::map<std::string, Map*> regions;
     std::string currentRegion;
+    std::map<std::string, std::set<std::pair<int, int>>> clearedDungeons; // looted, per region
     Shop* shop;
+    AutoSave* autosave;
+    std::string profileName;  // save store profile, the character's name
+    bool profileClaimed;      // profileName is held open against other sessions
     bool gameRunning;
+    bool savingEnabled;
+    bool victory;
+    WorldClock clock;
+
+    Prompt prompt;
+    std::string newName;                    // between NAME and CLASS
+    std::vector<std::string> profileChoices; // listed at PROFILE
+    Battle* battle;
+    Enemy* battleEnemy;
+    BattleKind battleKind;
+    int dungeonBattle;   // current fight in the dungeon, from 0
+    int dungeonBattles;
+    bool redrawMap;      // moved this turn; show the map when the turn ends
+    FramePacer pacer;    // whether the end of a turn draws the map and menu
     
     void initializeRegions();
-    void handleMovement(char direction);
+    void finishGame();
+    void enterWorld();
+    void drawMap();
+    void showActions();
+    void onCommand(const std::string& line);
+    void runCommand(char command);
+    void onUseItem(const std::string& line);
+    void onSaveOnQuit(const std::string& line);
+    void finishCommand();
+    void endTurn(bool showMenu);
+    void applyRegen();
+    // False if the way is blocked; announce=false leaves out "You move to"
+    bool handleMovement(char direction, bool announce = true);
     void handleRandomEncounter();
-    Enemy* generateRandomEnemy();
+    void startBattle(Enemy* enemy, BattleKind kind);
+    void onBattleOver();
     void handleTownInteraction();
+    void onTown(const std::string& line);
+    void travelTo(const std::string& region);
+    void onShop(const std::string& line);
     void handleDungeon();
+    void onDungeon(const std::string& line);
+    void startDungeonBattle();
+    void claimDungeonTreasure();
     void handleCastle();
+    void onCastle(const std::string& line);
     void displayMainMenu();
+    void onMainMenu(const std::string& line);
     void createNewGame();
-    bool loadGame();
+    void onName(const std::string& line);
+    void onReplace(const std::string& line);
+    void chooseClass();
+    void onClass(const std::string& line);
+    void onIntro();
+    void loadGame();
+    void onProfile(const std::string& line);
+    void loadProfile(const std::string& profile);
     void saveGame();
+    std::string buildSaveImage();
+    void writeWorldSections(SaveFormat::Writer& writer);
+    bool readWorldSections(const SaveFormat::SaveFile& save);
     void displayHelp();
 
 public:
-    Game();
+    Game();  // reads from the terminal
+    explicit Game(CommandSource& source);
     ~Game();
+    Game(const Game&) = delete;
+    Game& operator=(const Game&) = delete;
     
+    // Play to the end, reading every answer from the CommandSource
     void run();
+
+    // Show the title and main menu
+    void start();
+    // Answer the current prompt
+    void feed(const std::string& line);
+    // No more input is coming: settle the current prompt and finish
+    void endOfInput();
+
+    Prompt getPrompt() const { return prompt; }
+    bool isFinished() const { return prompt == Prompt::FINISHED; }
+    bool isVictory() const { return victory; }
+    // Empty until a character exists
+    std::string getPlayerName() const { return player ? player->getName() : std::string(); }
+    const std::string& getCurrentRegion() const { return currentRegion; }
+
+    // Bot interface: the state a player would read off the screen, and
+    // the answers the current prompt accepts (feed() takes any of them)
+    void observe(Observation& observation, int windowRadius = 4) const;
+    void legalActions(std::vector<std::string>& actions) const;
+    // Never touch the save store or journals (benchmarks, bots); call
+    // before start()
+    void disableSaving() { savingEnabled = false; }
+    // Let the pacer skip the map and menu at the end of a turn while a
+    // newer command is waiting (run() paces a terminal on its own)
+    void setPacer(const FramePacer& framePacer) { pacer = framePacer; }
+
+    // A random enemy for the current region and player level, owned by
+    // the caller; needs a character
+    Enemy* generateRandomEnemy();
 };
 
 #endif
@@ -0,0 +1,170 @@
+#include "Latency.h"
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace Latency {
+    static const int PHASES = static_cast<int>(Phase::COUNT);
+    static const int SUB_BITS = 4;
+    static const int SUB = 1 << SUB_BITS;            // linear steps per power of two
+    static const int BUCKETS = SUB + (64 - SUB_BITS) * SUB;
+
+    // One thread's counts. Only the owner adds; readers load concurrently.
+    struct Histograms {
+        std::atomic<uint64_t> counts[PHASES][BUCKETS];
+
+        Histograms() {
+            for (int p = 0; p < PHASES; p++) {
+                for (int b = 0; b < BUCKETS; b++) {
+                    counts[p][b].store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+    };
+
+    // Blocks are never freed: a thread that exits hands its block (counts
+    // and all) to the next thread that starts recording
+    static std::mutex registryMutex;
+    static std::vector<Histograms*> everyBlock;
+    static std::vector<Histograms*> unusedBlocks;
+
+    namespace {
+        struct ThreadBlock {
+            Histograms* block;
+
+            ThreadBlock() {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                if (!unusedBlocks.empty()) {
+                    block = unusedBlocks.back();
+                    unusedBlocks.pop_back();
+                } else {
+                    block = new Histograms();
+                    everyBlock.push_back(block);
+                }
+            }
+            ~ThreadBlock() {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                unusedBlocks.push_back(block);
+            }
+        };
+    }
+
+    static Histograms& mine() {
+        static thread_local ThreadBlock local;
+        return *local.block;
+    }
+
+    static int bucketFor(uint64_t value) {
+        if (value < static_cast<uint64_t>(SUB)) {
+            return static_cast<int>(value);
+        }
+        int top = 63 - __builtin_clzll(value);
+        int shift = top - SUB_BITS;
+        return SUB + shift * SUB + static_cast<int>((value >> shift) & (SUB - 1));
+    }
+
+    // Largest value that lands in the bucket
+    static uint64_t upperBound(int bucket) {
+        if (bucket < SUB) {
+            return static_cast<uint64_t>(bucket);
+        }
+        int shift = (bucket - SUB) / SUB;
+        uint64_t step = static_cast<uint64_t>(1) << shift;
+        uint64_t lower = static_cast<uint64_t>(SUB + (bucket - SUB) % SUB) << shift;
+        return lower + (step - 1);
+    }
+
+    const char* phaseName(Phase phase) {
+        switch (phase) {
+            case Phase::TURN: return "turn";
+            case Phase::PARSE: return "parse";
+            case Phase::LOGIC: return "logic";
+            case Phase::BATTLE: return "battle";
+            case Phase::RENDER: return "render";
+            case Phase::FLUSH: return "flush";
+            case Phase::KEY: return "key";
+            default: return "?";
+        }
+    }
+
+    void record(Phase phase, uint64_t nanoseconds) {
+        std::atomic<uint64_t>& slot = mine().counts[static_cast<int>(phase)][bucketFor(nanoseconds)];
+        // Single writer: a plain load and store, no locked instruction
+        slot.store(slot.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    Summary summarize(Phase phase) {
+        std::vector<uint64_t> merged(BUCKETS, 0);
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            for (Histograms* block : everyBlock) {
+                for (int b = 0; b < BUCKETS; b++) {
+                    merged[b] += block->counts[static_cast<int>(phase)][b].load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        Summary summary = {0, 0, 0, 0, 0};
+        for (int b = 0; b < BUCKETS; b++) {
+            summary.count += merged[b];
+            if (merged[b] > 0) {
+                summary.max = upperBound(b);
+            }
+        }
+        if (summary.count == 0) {
+            return summary;
+        }
+        // Smallest value with at least the wanted share of samples at or below it
+        uint64_t* targets[3] = {&summary.p50, &summary.p99, &summary.p999};
+        const double shares[3] = {0.50, 0.99, 0.999};
+        for (int t = 0; t < 3; t++) {
+            uint64_t rank = static_cast<uint64_t>(shares[t] * summary.count);
+            if (rank == 0) rank = 1;
+            uint64_t seen = 0;
+            for (int b = 0; b < BUCKETS; b++) {
+                seen += merged[b];
+                if (seen >= rank) {
+                    *targets[t] = upperBound(b);
+                    break;
+                }
+            }
+        }
+        return summary;
+    }
+
+    static std::string formatDuration(uint64_t nanoseconds) {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1);
+        if (nanoseconds < 1000) {
+            text << nanoseconds << "ns";
+        } else if (nanoseconds < 1000000) {
+            text << nanoseconds / 1e3 << "us";
+        } else if (nanoseconds < 1000000000) {
+            text << nanoseconds / 1e6 << "ms";
+        } else {
+            text << nanoseconds / 1e9 << "s";
+        }
+        return text.str();
+    }
+
+    void report(std::ostream& out) {
+        out << std::left << std::setw(8) << "phase" << std::right << std::setw(10) << "count"
+            << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+            << std::setw(10) << "max" << "\n";
+        for (int p = 0; p < PHASES; p++) {
+            Phase phase = static_cast<Phase>(p);
+            Summary summary = summarize(phase);
+            if (summary.count == 0) {
+                continue;
+            }
+            out << std::left << std::setw(8) << phaseName(phase) << std::right
+                << std::setw(10) << summary.count
+                << std::setw(10) << formatDuration(summary.p50)
+                << std::setw(10) << formatDuration(summary.p99)
+                << std::setw(10) << formatDuration(summary.p999)
+                << std::setw(10) << formatDuration(summary.max) << "\n";
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Where the time goes while the game answers a line of input. Every thread
+// records into histograms of its own, so timing a phase costs two clock
+// reads and an uncontended atomic add; readers merge all threads' counts.
+// Buckets are log-linear: 16 per power of two, so a percentile is within
+// about 6% of the true value from nanoseconds to minutes. Phases nest
+// (LOGIC includes the menus a town visit draws), so they need not add up.
+namespace Latency {
+    enum class Phase {
+        TURN,     // Game::feed(): a line in, its output complete
+        PARSE,    // trimming and decoding the line
+        LOGIC,    // movement, encounters, towns and dungeons
+        BATTLE,   // one battle action and the enemy's reply
+        RENDER,   // the map, menus and stat screens
+        FLUSH,    // handing finished output to the terminal or socket
+        KEY,      // a keystroke read (--keys) to its first frame on screen
+        COUNT
+    };
+
+    const char* phaseName(Phase phase);
+
+    void record(Phase phase, uint64_t nanoseconds);
+
+    // Times its own lifetime into a phase
+    class Scope {
+    private:
+        Phase phase;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit Scope(Phase timed) : phase(timed), start(std::chrono::steady_clock::now()) {}
+        ~Scope() {
+            record(phase, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                    std::chrono::steady_clock::now() - start).count()));
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    struct Summary {
+        uint64_t count;
+        uint64_t p50, p99, p999, max;  // nanoseconds, bucket upper bounds
+    };
+
+    // Counts from every thread since the process started
+    Summary summarize(Phase phase);
+    // One line per phase that has been recorded
+    void report(std::ostream& out);
+}
+
+#endif
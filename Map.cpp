@@ -1,5 +1,8 @@
 #include "Map.h"
 #include "Colors.h"
+#include "Console.h"
+#include "Trace.h"
+#include "Ui.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -7,6 +10,95 @@
 #include <cstdlib>
 #include <iomanip>
 
+namespace {
+    // A color that first clears whatever came before it ("\033[0;32m"), so
+    // switching from a bold style to a plain one needs no separate RESET
+    std::string afterReset(const char* color) {
+        return std::string("\033[0;") + (color + 2); // skip ESC '['
+    }
+
+    // One entry per color, so tiles that share a color share a run
+    struct TileStyles {
+        std::string plain, frame, green, brightWhite, brightYellow, yellow, white, blue, magenta,
+            brightRed, brightCyan;
+
+        TileStyles()
+            : plain(Colors::RESET), frame(afterReset(Colors::BRIGHT_BLUE)), green(afterReset(Colors::GREEN)),
+              brightWhite(afterReset(Colors::BRIGHT_WHITE)), brightYellow(afterReset(Colors::BRIGHT_YELLOW)),
+              yellow(afterReset(Colors::YELLOW)), white(afterReset(Colors::WHITE)), blue(afterReset(Colors::BLUE)),
+              magenta(afterReset(Colors::MAGENTA)), brightRed(afterReset(Colors::BRIGHT_RED)),
+              brightCyan(afterReset(Colors::BRIGHT_CYAN)) {}
+    };
+
+    const TileStyles& styles() {
+        static const TileStyles table;
+        return table;
+    }
+
+    // How a tile is drawn: its style plus a glyph for the box-drawing maps
+    // and a letter for the ASCII one
+    struct TileLook {
+        const std::string* style;
+        const char* glyph;
+        const char* letter;
+    };
+
+    TileLook lookOf(char tile) {
+        const TileStyles& s = styles();
+        switch (tile) {
+            case '.': return {&s.green, "·", "."};
+            case '#': return {&s.brightWhite, "█", "#"};
+            case 'T': return {&s.brightYellow, "☆", "T"};
+            case 'F': return {&s.green, "▲", "F"};
+            case 'D': return {&s.yellow, "◆", "D"};
+            case 'M': return {&s.white, "▲", "M"};
+            case 'W': return {&s.blue, "~", "~"};
+            case '~': return {&s.magenta, "◆", "*"};
+            case 'C': return {&s.brightRed, "✦", "C"};
+            default: return {&s.plain, " ", " "};
+        }
+    }
+
+    // Places a mip cell remembers, so an overview still shows a lone town
+    // in a block that is mostly forest
+    const unsigned char PLACE_TOWN = 1;
+    const unsigned char PLACE_DUNGEON = 2;
+    const unsigned char PLACE_CASTLE = 4;
+
+    unsigned char placeOf(char tile) {
+        switch (tile) {
+            case 'T': return PLACE_TOWN;
+            case '~': return PLACE_DUNGEON;
+            case 'C': return PLACE_CASTLE;
+            default: return 0;
+        }
+    }
+
+    // Writes runs of tiles, sending an escape sequence only when the style
+    // changes. A row of desert is one color code and one glyph per tile
+    // instead of a color code and a RESET around every tile.
+    class StyleRun {
+    private:
+        std::ostream& out;
+        const std::string* current;
+
+    public:
+        // Nothing is assumed about the style in effect before the run
+        explicit StyleRun(std::ostream& stream) : out(stream), current(nullptr) {}
+
+        std::ostream& use(const std::string& style) {
+            if (&style != current) {
+                out << style;
+                current = &style;
+            }
+            return out;
+        }
+
+        // Back to the terminal's own colors
+        void finish() { use(styles().plain); }
+    };
+}
+
 Map::Map() : width(0), height(0), regionName("Unknown") {}
 
 Map::Map(const std::string& mapFile) {
@@ -14,6 +106,7 @@ Map::Map(const std::string& mapFile) {
 }
 
 bool Map::loadFromFile(const std::string& mapFile) {
+    Trace::Span span("Map::loadFromFile");
     std::ifstream file(mapFile);
     if (!file.is_open()) {
         std::cerr << "Error: Could not load map file " << mapFile << "\n";
@@ -43,6 +136,12 @@ bool Map::loadFromFile(const std::string& mapFile) {
         }
         grid.push_back(row);
     }
+    // Short files still get a full-size grid
+    while (static_cast<int>(grid.size()) < height) {
+        grid.push_back(std::vector<char>(width, ' '));
+    }
+    resetChunks();
+    buildMips();
     
     file.close();
     return true;
@@ -105,226 +204,209 @@ std::string Map::getTileDescription(char tile) const {
 
 void Map::display(int playerX, int playerY) const {
     // Title
-    std::cout << "\n" << Colors::BRIGHT_CYAN;
-    std::cout << "╔════════════════════════════════════════════════════════════╗\n";
-    std::cout << "║ " << Colors::BRIGHT_YELLOW << "MAP: " << std::string((48 - regionName.length()) / 2, ' ') 
-              << regionName << std::string(48 - (48 - regionName.length()) / 2 - regionName.length(), ' ')
-              << Colors::BRIGHT_CYAN << " ║\n";
-    std::cout << "╚════════════════════════════════════════════════════════════╝\n" << Colors::RESET;
+    Console::out() << "\n" << Colors::BRIGHT_CYAN;
+    Console::out() << "╔════════════════════════════════════════════════════════════╗\n";
+    Console::out() << "║" << Colors::BRIGHT_YELLOW << Ui::center("MAP: " + regionName, 60) << Colors::BRIGHT_CYAN << "║\n";
+    Console::out() << "╚════════════════════════════════════════════════════════════╝\n" << Colors::RESET;
     
     // Legend row 1
-    std::cout << "\n" << Colors::BRIGHT_GREEN << "┌─ LEGEND ─────────────────────────────────────────────────────────┐\n" << Colors::RESET;
-    std::cout << Colors::BRIGHT_GREEN << "│ " << Colors::RESET;
-    std::cout << Colors::GREEN << "● Grass " << Colors::RESET << "  ";
-    std::cout << Colors::BRIGHT_WHITE << "■ Wall " << Colors::RESET << "   ";
-    std::cout << Colors::BRIGHT_YELLOW << "☆ Town " << Colors::RESET << "  ";
-    std::cout << Colors::GREEN << "▲ Forest " << Colors::RESET << "  ";
-    std::cout << Colors::YELLOW << "◆ Desert " << Colors::RESET << " ";
-    std::cout << Colors::BRIGHT_GREEN << "│\n" << Colors::RESET;
-    
-    std::cout << Colors::BRIGHT_GREEN << "│ " << Colors::RESET;
-    std::cout << Colors::WHITE << "▲ Mountain " << Colors::RESET << " ";
-    std::cout << Colors::BLUE << "~ Water " << Colors::RESET << "   ";
-    std::cout << Colors::MAGENTA << "◆ Dungeon " << Colors::RESET << "  ";
-    std::cout << Colors::BRIGHT_RED << "✦ Castle " << Colors::RESET << "   ";
-    std::cout << Colors::BRIGHT_CYAN << "@ You" << Colors::RESET << "  ";
-    std::cout << Colors::BRIGHT_GREEN << "│\n" << Colors::RESET;
-    std::cout << Colors::BRIGHT_GREEN << "└──────────────────────────────────────────────────────────────────┘\n" << Colors::RESET;
+    Console::out() << "\n" << Colors::BRIGHT_GREEN << "┌─ LEGEND ─────────────────────────────────────────────────────────┐\n" << Colors::RESET;
+    static const Ui::Template legend(
+        std::string(Colors::BRIGHT_GREEN) + "│ " + Colors::RESET +
+        Colors::GREEN + "● Grass " + Colors::RESET + "  " +
+        Colors::BRIGHT_WHITE + "■ Wall " + Colors::RESET + "   " +
+        Colors::BRIGHT_YELLOW + "☆ Town " + Colors::RESET + "  " +
+        Colors::GREEN + "▲ Forest " + Colors::RESET + "  " +
+        Colors::YELLOW + "◆ Desert " + Colors::RESET +
+        Colors::BRIGHT_GREEN + "{@67}│\n" + Colors::RESET +
+        Colors::BRIGHT_GREEN + "│ " + Colors::RESET +
+        Colors::WHITE + "▲ Mountain " + Colors::RESET + " " +
+        Colors::BLUE + "~ Water " + Colors::RESET + "   " +
+        Colors::MAGENTA + "◆ Dungeon " + Colors::RESET + "  " +
+        Colors::BRIGHT_RED + "✦ Castle " + Colors::RESET + "   " +
+        Colors::BRIGHT_CYAN + "@ You" + Colors::RESET +
+        Colors::BRIGHT_GREEN + "{@67}│\n" + Colors::RESET);
+    legend.render(Console::out());
+    Console::out() << Colors::BRIGHT_GREEN << "└──────────────────────────────────────────────────────────────────┘\n" << Colors::RESET;
     
     // Position info
-    std::cout << Colors::BRIGHT_YELLOW << "\nCurrent Position: " << Colors::CYAN << "(" << playerX << ", " << playerY << ")" << Colors::RESET;
-    std::cout << " | " << Colors::BRIGHT_YELLOW << "Map Size: " << Colors::CYAN << width << "×" << height << Colors::RESET << "\n\n";
+    Console::out() << Colors::BRIGHT_YELLOW << "\nCurrent Position: " << Colors::CYAN << "(" << playerX << ", " << playerY << ")" << Colors::RESET;
+    Console::out() << " | " << Colors::BRIGHT_YELLOW << "Map Size: " << Colors::CYAN << width << "×" << height << Colors::RESET << "\n\n";
     
     // Column indices (tens and units)
-    std::cout << "    ";
+    Console::out() << "    ";
     if (width > 9) {
         // tens row
         for (int x = 0; x < width; x++) {
             int t = x / 10;
-            if (t == 0) std::cout << ' ';
-            else std::cout << t;
+            if (t == 0) Console::out() << ' ';
+            else Console::out() << t;
         }
-        std::cout << "\n    ";
+        Console::out() << "\n    ";
     }
     // units row
-    for (int x = 0; x < width; x++) std::cout << (x % 10);
-    std::cout << "\n";
+    for (int x = 0; x < width; x++) Console::out() << (x % 10);
+    Console::out() << "\n";
 
     // Map border
-    std::cout << Colors::BRIGHT_BLUE << "   ┌";
+    Console::out() << Colors::BRIGHT_BLUE << "   ┌";
     for (int i = 0; i < width; i++) {
-        std::cout << "─";
+        Console::out() << "─";
     }
-    std::cout << "┐\n";
+    Console::out() << "┐\n";
     
+    
+    StyleRun run(Console::out());
     for (int y = 0; y < height; y++) {
-    // Y coordinate (aligned)
-    std::cout << Colors::BRIGHT_BLUE << std::setw(3) << y << " │" << Colors::RESET;
+        // Y coordinate (aligned)
+        run.use(styles().frame) << std::setw(3) << y << " │";
         
         // Map content
         for (int x = 0; x < width; x++) {
             if (x == playerX && y == playerY) {
                 // Make player marker stand out
-                std::cout << Colors::BRIGHT_MAGENTA << Colors::BRIGHT_WHITE << "@" << Colors::RESET;
+                run.use(styles().brightWhite) << "@";
             } else {
-                char tile = getTileAt(x, y);
-                switch(tile) {
-                    case '.': std::cout << Colors::GREEN << "·" << Colors::RESET; break;
-                    case '#': std::cout << Colors::BRIGHT_WHITE << "█" << Colors::RESET; break;
-                    case 'T': std::cout << Colors::BRIGHT_YELLOW << "☆" << Colors::RESET; break;
-                    case 'F': std::cout << Colors::GREEN << "▲" << Colors::RESET; break;
-                    case 'D': std::cout << Colors::YELLOW << "◆" << Colors::RESET; break;
-                    case 'M': std::cout << Colors::WHITE << "▲" << Colors::RESET; break;
-                    case 'W': std::cout << Colors::BLUE << "~" << Colors::RESET; break;
-                    case '~': std::cout << Colors::MAGENTA << "◆" << Colors::RESET; break;
-                    case 'C': std::cout << Colors::BRIGHT_RED << "✦" << Colors::RESET; break;
-                    default: std::cout << " ";
-                }
+                TileLook look = lookOf(getTileAt(x, y));
+                run.use(*look.style) << look.glyph;
             }
         }
-        std::cout << Colors::BRIGHT_BLUE << "│\n" << Colors::RESET;
+        run.use(styles().frame) << "│\n";
     }
+    run.finish();
     
     // Bottom border and repeat column indices for readability
-    std::cout << Colors::BRIGHT_BLUE << "   └";
-    for (int i = 0; i < width; i++) std::cout << "─";
-    std::cout << "┘\n" << Colors::RESET;
+    Console::out() << Colors::BRIGHT_BLUE << "   └";
+    for (int i = 0; i < width; i++) Console::out() << "─";
+    Console::out() << "┘\n" << Colors::RESET;
 
     if (width > 9) {
-        std::cout << "    ";
+        Console::out() << "    ";
         for (int x = 0; x < width; x++) {
             int t = x / 10;
-            if (t == 0) std::cout << ' ';
-            else std::cout << t;
+            if (t == 0) Console::out() << ' ';
+            else Console::out() << t;
         }
-        std::cout << "\n    ";
+        Console::out() << "\n    ";
     }
-    for (int x = 0; x < width; x++) std::cout << (x % 10);
-    std::cout << "\n\n" << Colors::RESET;
+    for (int x = 0; x < width; x++) Console::out() << (x % 10);
+    Console::out() << "\n\n" << Colors::RESET;
 }
 
 void Map::displayStyled(int playerX, int playerY, bool useEmoji) const {
+    Trace::Span span("Map::displayStyled");
     // Map header
-    std::cout << "\n" << Colors::BRIGHT_CYAN;
-    std::cout << "╔══════════════════════════════════════════════════╗\n";
+    Console::out() << "\n" << Colors::BRIGHT_CYAN;
+    Console::out() << "╔══════════════════════════════════════════════════╗\n";
     
-    // Center the region name
-    std::string mapTitle = "🗺️  " + regionName;
-    int titlePad = (46 - regionName.length()) / 2;
-    std::cout << "║ " << std::string(titlePad, ' ') << Colors::BRIGHT_YELLOW << mapTitle 
-              << std::string(46 - titlePad - regionName.length(), ' ') << Colors::BRIGHT_CYAN << " ║\n";
-    std::cout << "╚══════════════════════════════════════════════════╝\n" << Colors::RESET;
+    Console::out() << "║" << Colors::BRIGHT_YELLOW << Ui::center("🗺️ " + regionName, 50) << Colors::BRIGHT_CYAN << "║\n";
+    Console::out() << "╚══════════════════════════════════════════════════╝\n" << Colors::RESET;
 
     if (useEmoji) {
         // Emoji legend
-        std::cout << "\n" << Colors::BRIGHT_GREEN << "┌─ LEGEND ─────────────────────────────────────────┐\n";
-        std::cout << "│ 🌿 Grass  🧱 Wall  🏘️  Town  🌲 Forest  🏜️  Desert │\n";
-        std::cout << "│ ⛰️  Mountain  💧 Water  🕳️  Dungeon  🏰 Castle    │\n";
-        std::cout << "│ " << Colors::BRIGHT_CYAN << "⭐ YOU (Current Position)" << Colors::BRIGHT_GREEN << "                       │\n";
-        std::cout << "└───────────────────────────────────────────────────┘\n" << Colors::RESET;
+        static const Ui::Template legend(
+            "\n" + std::string(Colors::BRIGHT_GREEN) + "┌─ LEGEND ─────────────────────────────────────────┐\n"
+            "│ 🌿 Grass  🧱 Wall  🏘️ Town  🌲 Forest  🏜️ Desert{@51}│\n"
+            "│ ⛰️ Mountain  💧 Water  🕳️ Dungeon  🏰 Castle{@51}│\n"
+            "│ " + Colors::BRIGHT_CYAN + "⭐ YOU (Current Position)" + Colors::BRIGHT_GREEN + "{@51}│\n"
+            "└──────────────────────────────────────────────────┘\n" + Colors::RESET);
+        legend.render(Console::out());
     } else {
         // ASCII legend
-        std::cout << "\n" << Colors::BRIGHT_GREEN << "┌─ LEGEND ─────────────────────────────────────────┐\n" << Colors::RESET;
-        std::cout << Colors::BRIGHT_GREEN << "│ " << Colors::RESET;
-        std::cout << Colors::GREEN << ". Grass  " << Colors::RESET;
-        std::cout << Colors::BRIGHT_WHITE << "# Wall  " << Colors::RESET;
-        std::cout << Colors::BRIGHT_YELLOW << "T Town  " << Colors::RESET;
-        std::cout << Colors::GREEN << "F Forest  " << Colors::RESET;
-        std::cout << Colors::YELLOW << "D Desert  " << Colors::RESET;
-        std::cout << Colors::BRIGHT_GREEN << "│\n" << Colors::RESET;
-        std::cout << Colors::BRIGHT_GREEN << "│ " << Colors::RESET;
-        std::cout << Colors::WHITE << "M Mountain  " << Colors::RESET;
-        std::cout << Colors::BLUE << "~ Water  " << Colors::RESET;
-        std::cout << Colors::MAGENTA << "* Dungeon  " << Colors::RESET;
-        std::cout << Colors::BRIGHT_RED << "C Castle  " << Colors::RESET;
-        std::cout << Colors::BRIGHT_CYAN << "@ YOU" << Colors::RESET << " ";
-        std::cout << Colors::BRIGHT_GREEN << "│\n" << Colors::RESET;
-        std::cout << Colors::BRIGHT_GREEN << "└───────────────────────────────────────────────────┘\n" << Colors::RESET;
+        static const Ui::Template legend(
+            "\n" + std::string(Colors::BRIGHT_GREEN) + "┌─ LEGEND ─────────────────────────────────────────┐\n" + Colors::RESET +
+            Colors::BRIGHT_GREEN + "│ " + Colors::RESET +
+            Colors::GREEN + ". Grass  " + Colors::RESET +
+            Colors::BRIGHT_WHITE + "# Wall  " + Colors::RESET +
+            Colors::BRIGHT_YELLOW + "T Town  " + Colors::RESET +
+            Colors::GREEN + "F Forest  " + Colors::RESET +
+            Colors::YELLOW + "D Desert" + Colors::RESET +
+            Colors::BRIGHT_GREEN + "{@51}│\n" + Colors::RESET +
+            Colors::BRIGHT_GREEN + "│ " + Colors::RESET +
+            Colors::WHITE + "M Mountain  " + Colors::RESET +
+            Colors::BLUE + "~ Water  " + Colors::RESET +
+            Colors::MAGENTA + "* Dungeon  " + Colors::RESET +
+            Colors::BRIGHT_RED + "C Castle  " + Colors::RESET +
+            Colors::BRIGHT_CYAN + "@ YOU" + Colors::RESET +
+            Colors::BRIGHT_GREEN + "{@51}│\n" + Colors::RESET +
+            Colors::BRIGHT_GREEN + "└──────────────────────────────────────────────────┘\n" + Colors::RESET);
+        legend.render(Console::out());
     }
 
     // Position info
-    std::cout << Colors::BRIGHT_YELLOW << "\n📍 Position: " << Colors::CYAN << "(" << playerX << ", " << playerY << ")" << Colors::RESET;
-    std::cout << "  " << Colors::BRIGHT_YELLOW << "📐 Size: " << Colors::CYAN << width << "x" << height << Colors::RESET << "\n\n";
+    Console::out() << Colors::BRIGHT_YELLOW << "\n📍 Position: " << Colors::CYAN << "(" << playerX << ", " << playerY << ")" << Colors::RESET;
+    Console::out() << "  " << Colors::BRIGHT_YELLOW << "📐 Size: " << Colors::CYAN << width << "x" << height << Colors::RESET << "\n\n";
 
     if (useEmoji) {
         // Emoji map - each emoji takes 2 columns
         // Column indices header (spaced for emoji width)
-        std::cout << "      ";
+        Console::out() << "      ";
         for (int x = 0; x < width; x++) {
-            std::cout << (x % 10) << " ";
+            Console::out() << (x % 10) << " ";
         }
-        std::cout << "\n";
+        Console::out() << "\n";
 
         // Top border
-        std::cout << Colors::BRIGHT_BLUE << "     +" << std::string(width * 2, '-') << "+\n";
+        Console::out() << Colors::BRIGHT_BLUE << "     +" << std::string(width * 2, '-') << "+\n";
 
         // Map rows with emoji
         for (int y = 0; y < height; y++) {
-            std::cout << Colors::BRIGHT_BLUE << std::setw(4) << y << " |" << Colors::RESET;
+            Console::out() << Colors::BRIGHT_BLUE << std::setw(4) << y << " |" << Colors::RESET;
             
             for (int x = 0; x < width; x++) {
                 if (x == playerX && y == playerY) {
-                    std::cout << "⭐";
+                    Console::out() << "⭐";
                 } else {
                     char tile = getTileAt(x, y);
                     switch(tile) {
-                        case '.': std::cout << "🌿"; break;
-                        case '#': std::cout << "🧱"; break;
-                        case 'T': std::cout << "🏘️ "; break;
-                        case 'F': std::cout << "🌲"; break;
-                        case 'D': std::cout << "🏜️ "; break;
-                        case 'M': std::cout << "⛰️ "; break;
-                        case 'W': std::cout << "💧"; break;
-                        case '~': std::cout << "🕳️ "; break;
-                        case 'C': std::cout << "🏰"; break;
-                        default:  std::cout << "  ";
+                        case '.': Console::out() << "🌿"; break;
+                        case '#': Console::out() << "🧱"; break;
+                        case 'T': Console::out() << "🏘️"; break;
+                        case 'F': Console::out() << "🌲"; break;
+                        case 'D': Console::out() << "🏜️"; break;
+                        case 'M': Console::out() << "⛰️"; break;
+                        case 'W': Console::out() << "💧"; break;
+                        case '~': Console::out() << "🕳️"; break;
+                        case 'C': Console::out() << "🏰"; break;
+                        default:  Console::out() << "  ";
                     }
                 }
             }
-            std::cout << Colors::BRIGHT_BLUE << "|\n" << Colors::RESET;
+            Console::out() << Colors::BRIGHT_BLUE << "|\n" << Colors::RESET;
         }
 
         // Bottom border
-        std::cout << Colors::BRIGHT_BLUE << "     +" << std::string(width * 2, '-') << "+\n" << Colors::RESET;
+        Console::out() << Colors::BRIGHT_BLUE << "     +" << std::string(width * 2, '-') << "+\n" << Colors::RESET;
     } else {
         // ASCII map (original)
-        std::cout << "     ";
+        Console::out() << "     ";
         for (int x = 0; x < width; x++) {
-            std::cout << (x % 10);
+            Console::out() << (x % 10);
         }
-        std::cout << "\n";
+        Console::out() << "\n";
 
-        std::cout << Colors::BRIGHT_BLUE << "    +" << std::string(width, '-') << "+\n";
+        Console::out() << Colors::BRIGHT_BLUE << "    +" << std::string(width, '-') << "+\n";
 
+        StyleRun run(Console::out());
         for (int y = 0; y < height; y++) {
-            std::cout << Colors::BRIGHT_BLUE << std::setw(3) << y << " |" << Colors::RESET;
+            run.use(styles().frame) << std::setw(3) << y << " |";
             
             for (int x = 0; x < width; x++) {
                 if (x == playerX && y == playerY) {
-                    std::cout << Colors::BRIGHT_CYAN << "@" << Colors::RESET;
+                    run.use(styles().brightCyan) << "@";
                 } else {
-                    char tile = getTileAt(x, y);
-                    switch(tile) {
-                        case '.': std::cout << Colors::GREEN << "." << Colors::RESET; break;
-                        case '#': std::cout << Colors::BRIGHT_WHITE << "#" << Colors::RESET; break;
-                        case 'T': std::cout << Colors::BRIGHT_YELLOW << "T" << Colors::RESET; break;
-                        case 'F': std::cout << Colors::GREEN << "F" << Colors::RESET; break;
-                        case 'D': std::cout << Colors::YELLOW << "D" << Colors::RESET; break;
-                        case 'M': std::cout << Colors::WHITE << "M" << Colors::RESET; break;
-                        case 'W': std::cout << Colors::BLUE << "~" << Colors::RESET; break;
-                        case '~': std::cout << Colors::MAGENTA << "*" << Colors::RESET; break;
-                        case 'C': std::cout << Colors::BRIGHT_RED << "C" << Colors::RESET; break;
-                        default: std::cout << " ";
-                    }
+                    TileLook look = lookOf(getTileAt(x, y));
+                    run.use(*look.style) << look.letter;
                 }
             }
-            std::cout << Colors::BRIGHT_BLUE << "|\n" << Colors::RESET;
+            run.use(styles().frame) << "|\n";
         }
+        run.finish();
 
-        std::cout << Colors::BRIGHT_BLUE << "    +" << std::string(width, '-') << "+\n" << Colors::RESET;
+        Console::out() << Colors::BRIGHT_BLUE << "    +" << std::string(width, '-') << "+\n" << Colors::RESET;
     }
 
-    std::cout << "\n";
+    Console::out() << "\n";
 }
 
 void Map::displayFull() const {
@@ -332,55 +414,102 @@ void Map::displayFull() const {
 }
 
 void Map::displayMinimap(int playerX, int playerY, int viewRange) const {
-    std::cout << "\n" << Colors::BRIGHT_CYAN;
-    std::cout << "╔═══════════════════════════════════════╗\n";
-    std::cout << "║ " << Colors::BRIGHT_YELLOW << "MINIMAP" << Colors::BRIGHT_CYAN 
-              << std::string(27, ' ') << "║\n";
-    std::cout << "╚═══════════════════════════════════════╝\n" << Colors::RESET;
+    Console::out() << "\n" << Colors::BRIGHT_CYAN;
+    Console::out() << "╔═══════════════════════════════════════╗\n";
+    Console::out() << "║ " << Colors::BRIGHT_YELLOW << Ui::left("MINIMAP", 38) << Colors::BRIGHT_CYAN << "║\n";
+    Console::out() << "╚═══════════════════════════════════════╝\n" << Colors::RESET;
     
     int startX = playerX - viewRange;
     int startY = playerY - viewRange;
     int endX = playerX + viewRange;
     int endY = playerY + viewRange;
     
-    std::cout << Colors::BRIGHT_BLUE << "   ┌";
+    Console::out() << Colors::BRIGHT_BLUE << "   ┌";
     for (int i = startX; i <= endX; i++) {
-        std::cout << "─";
+        Console::out() << "─";
     }
-    std::cout << "┐\n";
+    Console::out() << "┐\n";
     
+    StyleRun run(Console::out());
     for (int y = startY; y <= endY; y++) {
-        std::cout << Colors::BRIGHT_BLUE << "   │" << Colors::RESET;
+        run.use(styles().frame) << "   │";
         
         for (int x = startX; x <= endX; x++) {
             if (x == playerX && y == playerY) {
-                std::cout << Colors::BRIGHT_CYAN << "@" << Colors::RESET;
+                run.use(styles().brightCyan) << "@";
             } else if (isValidPosition(x, y)) {
-                char tile = getTileAt(x, y);
-                switch(tile) {
-                    case '.': std::cout << Colors::GREEN << "·" << Colors::RESET; break;
-                    case '#': std::cout << Colors::BRIGHT_WHITE << "█" << Colors::RESET; break;
-                    case 'T': std::cout << Colors::BRIGHT_YELLOW << "☆" << Colors::RESET; break;
-                    case 'F': std::cout << Colors::GREEN << "▲" << Colors::RESET; break;
-                    case 'D': std::cout << Colors::YELLOW << "◆" << Colors::RESET; break;
-                    case 'M': std::cout << Colors::WHITE << "▲" << Colors::RESET; break;
-                    case 'W': std::cout << Colors::BLUE << "~" << Colors::RESET; break;
-                    case '~': std::cout << Colors::MAGENTA << "◆" << Colors::RESET; break;
-                    case 'C': std::cout << Colors::BRIGHT_RED << "✦" << Colors::RESET; break;
-                    default: std::cout << " ";
-                }
+                TileLook look = lookOf(getTileAt(x, y));
+                run.use(*look.style) << look.glyph;
             } else {
-                std::cout << " ";
+                run.use(styles().plain) << " ";
             }
         }
-        std::cout << Colors::BRIGHT_BLUE << "│\n" << Colors::RESET;
+        run.use(styles().frame) << "│\n";
     }
+    run.finish();
     
-    std::cout << Colors::BRIGHT_BLUE << "   └";
+    Console::out() << Colors::BRIGHT_BLUE << "   └";
     for (int i = startX; i <= endX; i++) {
-        std::cout << "─";
+        Console::out() << "─";
     }
-    std::cout << "┘\n" << Colors::RESET << "\n";
+    Console::out() << "┘\n" << Colors::RESET << "\n";
+}
+
+void Map::displayOverview(int playerX, int playerY, int maxCells) const {
+    int level = 0;
+    int columns = width;
+    int rows = height;
+    while ((columns > maxCells || rows > maxCells) && level < static_cast<int>(mips.size())) {
+        level++;
+        columns = mips[level - 1].width;
+        rows = mips[level - 1].height;
+    }
+    int scale = 1 << level;
+
+    std::string title = "OVERVIEW  1 cell = " + std::to_string(scale) + "x" + std::to_string(scale) + " tiles";
+    Console::out() << "\n" << Colors::BRIGHT_CYAN;
+    Console::out() << "╔═══════════════════════════════════════╗\n";
+    Console::out() << "║ " << Colors::BRIGHT_YELLOW << Ui::left(title, 38)
+                   << Colors::BRIGHT_CYAN << "║\n";
+    Console::out() << "╚═══════════════════════════════════════╝\n" << Colors::RESET;
+
+    Console::out() << Colors::BRIGHT_BLUE << "   ┌";
+    for (int i = 0; i < columns; i++) {
+        Console::out() << "─";
+    }
+    Console::out() << "┐\n";
+
+    int playerColumn = isValidPosition(playerX, playerY) ? playerX / scale : -1;
+    int playerRow = playerY / scale;
+    StyleRun run(Console::out());
+    for (int y = 0; y < rows; y++) {
+        run.use(styles().frame) << "   │";
+        for (int x = 0; x < columns; x++) {
+            if (x == playerColumn && y == playerRow) {
+                run.use(styles().brightCyan) << "@";
+                continue;
+            }
+            MipCell cell = mipCell(level, x, y);
+            char shown = cell.tile;
+            if (cell.places & PLACE_CASTLE) {
+                shown = 'C';
+            } else if (cell.places & PLACE_DUNGEON) {
+                shown = '~';
+            } else if (cell.places & PLACE_TOWN) {
+                shown = 'T';
+            }
+            TileLook look = lookOf(shown);
+            run.use(*look.style) << look.glyph;
+        }
+        run.use(styles().frame) << "│\n";
+    }
+    run.finish();
+
+    Console::out() << Colors::BRIGHT_BLUE << "   └";
+    for (int i = 0; i < columns; i++) {
+        Console::out() << "─";
+    }
+    Console::out() << "┘\n" << Colors::RESET << "\n";
 }
 
 void Map::generateDefaultMap(const std::string& region) {
@@ -469,6 +598,8 @@ void Map::generateDefaultMap(const std::string& region) {
             grid.push_back(row);
         }
     }
+    resetChunks();
+    buildMips();
 }
 
 char Map::getTile(int x, int y) const {
@@ -476,8 +607,173 @@ char Map::getTile(int x, int y) const {
 }
 
 void Map::setTile(int x, int y, char tile) {
-    if (isValidPosition(x, y)) {
+    if (isValidPosition(x, y) && grid[y][x] != tile) {
         grid[y][x] = tile;
+        markChunkDirty((y / CHUNK_SIZE) * getChunksX() + x / CHUNK_SIZE);
+        updateMips(x, y, x + 1, y + 1);
+    }
+}
+
+void Map::resetChunks() {
+    dirtyChunks.assign(getChunkCount(), 0);
+    dirtyList.clear();
+    markAllChunksDirty();
+}
+
+void Map::markChunkDirty(int index) {
+    if (!dirtyChunks[index]) {
+        dirtyChunks[index] = 1;
+        dirtyList.push_back(index);
+    }
+}
+
+void Map::markAllChunksDirty() {
+    for (int i = 0; i < getChunkCount(); i++) {
+        markChunkDirty(i);
+    }
+}
+
+std::vector<int> Map::takeDirtyChunks() {
+    std::vector<int> taken;
+    taken.swap(dirtyList);
+    for (int index : taken) {
+        dirtyChunks[index] = 0;
+    }
+    return taken;
+}
+
+void Map::writeChunk(int index, SaveFormat::Writer& writer) const {
+    int startX = (index % getChunksX()) * CHUNK_SIZE;
+    int startY = (index / getChunksX()) * CHUNK_SIZE;
+    int endX = std::min(width, startX + CHUNK_SIZE);
+    int endY = std::min(height, startY + CHUNK_SIZE);
+    for (int y = startY; y < endY; y++) {
+        writer.putBytes(&grid[y][startX], endX - startX);
+    }
+}
+
+bool Map::readChunk(int index, SaveFormat::StringView payload) {
+    if (index < 0 || index >= getChunkCount()) {
+        return false;
+    }
+    int startX = (index % getChunksX()) * CHUNK_SIZE;
+    int startY = (index / getChunksX()) * CHUNK_SIZE;
+    int endX = std::min(width, startX + CHUNK_SIZE);
+    int endY = std::min(height, startY + CHUNK_SIZE);
+    size_t rowBytes = endX - startX;
+    if (payload.size != rowBytes * (endY - startY)) {
+        return false;
+    }
+    const char* src = payload.data;
+    for (int y = startY; y < endY; y++) {
+        std::copy(src, src + rowBytes, grid[y].begin() + startX);
+        src += rowBytes;
+    }
+    updateMips(startX, startY, endX, endY);
+    return true;
+}
+
+Map::MipCell Map::mipCell(int level, int x, int y) const {
+    if (level == 0) {
+        char tile = grid[y][x];
+        MipCell cell = {tile, placeOf(tile), 255};
+        return cell;
+    }
+    const MipLevel& mip = mips[level - 1];
+    return mip.cells[y * mip.width + x];
+}
+
+Map::MipCell Map::combineMips(int level, int x, int y) const {
+    int belowWidth = level == 1 ? width : mips[level - 2].width;
+    int belowHeight = level == 1 ? height : mips[level - 2].height;
+    // Each cell below votes for its tile with the share it covers
+    char tiles[4];
+    int shares[4];
+    int kinds = 0;
+    int present = 0;
+    unsigned char places = 0;
+    for (int by = 2 * y; by < std::min(2 * y + 2, belowHeight); by++) {
+        for (int bx = 2 * x; bx < std::min(2 * x + 2, belowWidth); bx++) {
+            MipCell below = mipCell(level - 1, bx, by);
+            places |= below.places;
+            present++;
+            int kind = 0;
+            while (kind < kinds && tiles[kind] != below.tile) {
+                kind++;
+            }
+            if (kind == kinds) {
+                tiles[kinds] = below.tile;
+                shares[kinds++] = 0;
+            }
+            shares[kind] += below.coverage;
+        }
+    }
+    int best = 0;
+    for (int kind = 1; kind < kinds; kind++) {
+        if (shares[kind] > shares[best]) {
+            best = kind;
+        }
+    }
+    MipCell cell = {tiles[best], places, static_cast<unsigned char>(shares[best] / present)};
+    return cell;
+}
+
+void Map::buildMips() {
+    mips.clear();
+    int levelWidth = width;
+    int levelHeight = height;
+    while (levelWidth > 1 || levelHeight > 1) {
+        MipLevel mip;
+        mip.width = (levelWidth + 1) / 2;
+        mip.height = (levelHeight + 1) / 2;
+        mip.cells.resize(static_cast<size_t>(mip.width) * mip.height);
+        mips.push_back(std::move(mip));
+        int level = static_cast<int>(mips.size());
+        MipLevel& built = mips.back();
+        for (int y = 0; y < built.height; y++) {
+            for (int x = 0; x < built.width; x++) {
+                built.cells[y * built.width + x] = combineMips(level, x, y);
+            }
+        }
+        levelWidth = built.width;
+        levelHeight = built.height;
+    }
+}
+
+void Map::updateMips(int x0, int y0, int x1, int y1) {
+    for (int level = 1; level <= static_cast<int>(mips.size()); level++) {
+        // The cells covering [x0, x1) x [y0, y1) one level up
+        x0 /= 2;
+        y0 /= 2;
+        x1 = (x1 + 1) / 2;
+        y1 = (y1 + 1) / 2;
+        MipLevel& mip = mips[level - 1];
+        bool changed = false;
+        for (int y = y0; y < y1; y++) {
+            for (int x = x0; x < x1; x++) {
+                MipCell cell = combineMips(level, x, y);
+                MipCell& kept = mip.cells[y * mip.width + x];
+                if (cell.tile != kept.tile || cell.places != kept.places || cell.coverage != kept.coverage) {
+                    kept = cell;
+                    changed = true;
+                }
+            }
+        }
+        if (!changed) {
+            return; // the levels above were built from the same cells
+        }
+    }
+}
+
+void Map::resize(const std::string& region, int newWidth, int newHeight) {
+    regionName = region;
+    if (newWidth == width && newHeight == height && static_cast<int>(grid.size()) == height) {
+        return;
     }
+    width = newWidth;
+    height = newHeight;
+    grid.assign(height, std::vector<char>(width, ' '));
+    resetChunks();
+    buildMips();
 }
 
@@ -3,17 +3,48 @@
 
 #include <string>
 #include <vector>
+#include "SaveFormat.h"
 
 class Map {
+public:
+    // Tiles are tracked for saving in square chunks; only chunks touched
+    // since the last save need to be written again.
+    static const int CHUNK_SIZE = 16;
+
 private:
     std::vector<std::vector<char>> grid;
     int width;
     int height;
     std::string regionName;
     std::string filename;
+    std::vector<char> dirtyChunks;   // one flag per chunk
+    std::vector<int> dirtyList;      // indices of flagged chunks
+
+    // Downsampled copies of the grid for overviews of large regions. Level
+    // k has one cell per 2^k x 2^k block of tiles (level 0 is the grid
+    // itself) holding the tile that covers most of the block and the
+    // places (towns, dungeons, castles) anywhere in it. Each level is built
+    // from the one below, so a changed tile updates one cell per level.
+    struct MipCell {
+        char tile;
+        unsigned char places;    // one bit per kind of place
+        unsigned char coverage;  // share of the block the tile covers, out of 255
+    };
+    struct MipLevel {
+        int width;
+        int height;
+        std::vector<MipCell> cells;
+    };
+    std::vector<MipLevel> mips;      // mips[k - 1] is level k
     
     char getTile(int x, int y) const;
-    void setTile(int x, int y, char tile);
+    void resetChunks();              // after (re)building the grid: all dirty
+    MipCell mipCell(int level, int x, int y) const;
+    // A level-k cell from the four cells below it
+    MipCell combineMips(int level, int x, int y) const;
+    void buildMips();                // after (re)building the grid
+    // Tiles in [x0, x1) x [y0, y1) changed
+    void updateMips(int x0, int y0, int x1, int y1);
 
 public:
     Map();
@@ -39,9 +70,25 @@ public:
     void displayStyled(int playerX, int playerY, bool useEmoji = false) const;
     void displayFull() const;
     void displayMinimap(int playerX, int playerY, int viewRange = 5) const;
+    // The whole region in at most maxCells cells a side, from the finest
+    // mip level that fits; places show through the terrain around them
+    void displayOverview(int playerX, int playerY, int maxCells = 32) const;
     
     // Map generation
     void generateDefaultMap(const std::string& region);
+    
+    // World state
+    void setTile(int x, int y, char tile);
+    int getChunksX() const { return (width + CHUNK_SIZE - 1) / CHUNK_SIZE; }
+    int getChunksY() const { return (height + CHUNK_SIZE - 1) / CHUNK_SIZE; }
+    int getChunkCount() const { return getChunksX() * getChunksY(); }
+    void markChunkDirty(int index);
+    void markAllChunksDirty();
+    // Hand out the chunks changed since the last call and clear their flags
+    std::vector<int> takeDirtyChunks();
+    void writeChunk(int index, SaveFormat::Writer& writer) const;
+    bool readChunk(int index, SaveFormat::StringView payload);
+    void resize(const std::string& region, int newWidth, int newHeight);
 };
 
 #endif
@@ -0,0 +1,49 @@
+#ifndef OBSERVATION_H
+#define OBSERVATION_H
+
+#include <string>
+#include <vector>
+
+// What a bot can see of a game without reading its rendered output. Filled
+// in by Game::observe(); `prompt` and `battlePrompt` hold the Game::Prompt
+// and Battle::Prompt values as ints so this header stays dependency-free.
+struct Observation {
+    int prompt;
+    bool finished;
+    bool victory;            // the Dark Lord has been defeated
+
+    // Player (zero until a character exists)
+    bool hasPlayer;
+    std::string region;
+    int x, y;
+    int level;
+    int experience;
+    int health, maxHealth;
+    int mana, maxMana;
+    int gold;
+    int attackPower, defensePower;
+    int potions;             // health potions carried
+
+    // Map tiles around the player, row by row; ' ' is outside the map
+    int windowRadius;
+    std::vector<std::string> mapWindow;
+
+    // Battle in progress
+    bool inBattle;
+    int battlePrompt;
+    std::string enemyName;
+    int enemyLevel;
+    int enemyHealth, enemyMaxHealth;
+
+    // Every answer the current prompt accepts (for free text such as the
+    // character name, one representative answer)
+    std::vector<std::string> legalActions;
+
+    Observation()
+        : prompt(0), finished(false), victory(false), hasPlayer(false), x(0), y(0), level(0),
+          experience(0), health(0), maxHealth(0), mana(0), maxMana(0), gold(0), attackPower(0),
+          defensePower(0), potions(0), windowRadius(0), inBattle(false), battlePrompt(0),
+          enemyLevel(0), enemyHealth(0), enemyMaxHealth(0) {}
+};
+
+#endif
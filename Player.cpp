@@ -1,15 +1,18 @@
 #include "Player.h"
 #include "Colors.h"
+#include "Console.h"
+#include "Trace.h"
+#include "Ui.h"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
 #include <cstdlib>
 #include <string>
-#include <iomanip>
 
 Player::Player(const std::string& playerName, PlayerClass pClass) 
     : name(playerName), playerClass(pClass), level(1), experience(0), 
-      experienceToNext(100), gold(50), x(0), y(0), currentRegion("Verdant Woods") {
+      experienceToNext(100), gold(50), x(0), y(0), currentRegion("Verdant Woods"),
+      regenTick(0), statsDirty(true), attackPower(0), defensePower(0) {
     initializeStats();
     initializeSkills();
 }
@@ -88,17 +91,24 @@ void Player::initializeStats() {
             agility = 15;
             break;
     }
+    markStatsDirty();
+}
+
+void Player::refreshDerivedStats() const {
+    attackPower = strength + (weapon.name.empty() ? 0 : weapon.value);
+    defensePower = defense + (armor.name.empty() ? 0 : armor.value);
+    statsDirty = false;
 }
 
 int Player::attack() const {
-    int baseDamage = strength;
+    int baseDamage = getAttackPower();
     // Add some randomness
     int damage = baseDamage + (rand() % 5);
     return damage;
 }
 
 int Player::defend() const {
-    return defense + (rand() % 3);
+    return getDefensePower() + (rand() % 3);
 }
 
 void Player::takeDamage(int damage) {
@@ -114,6 +124,22 @@ void Player::restoreMana(int amount) {
     mana = std::min(maxMana, mana + amount);
 }
 
+int Player::regenerate(uint64_t now) {
+    int amount = healthAt(now) - health;
+    regenTick = now;
+    health += amount;
+    return amount;
+}
+
+int Player::healthAt(uint64_t now) const {
+    uint64_t elapsed = now > regenTick ? now - regenTick : 0;
+    if (elapsed == 0 || health <= 0 || health >= maxHealth) {
+        return health;
+    }
+    int perTick = std::max(1, maxHealth / 50); // minimum 1 HP
+    return health + static_cast<int>(std::min<uint64_t>(elapsed * perTick, maxHealth - health));
+}
+
 void Player::gainExperience(int exp) {
     experience += exp;
     while (experience >= experienceToNext) {
@@ -149,13 +175,14 @@ void Player::levelUp() {
             agility += 3;
             break;
     }
+    markStatsDirty();
     
     // Restore health and mana on level up
     health = maxHealth;
     mana = maxMana;
     
-    std::cout << "\n" << Colors::BRIGHT_YELLOW << "🎆 *** LEVEL UP! *** 🎆\n";
-    std::cout << "You are now level " << level << "!\n" << Colors::RESET;
+    Console::out() << "\n" << Colors::BRIGHT_YELLOW << "🎆 *** LEVEL UP! *** 🎆\n";
+    Console::out() << "You are now level " << level << "!\n" << Colors::RESET;
     displayStats();
 }
 
@@ -182,65 +209,92 @@ void Player::useItem(const std::string& itemName) {
         if (it->type == "potion") {
             if (it->name.find("Health") != std::string::npos) {
                 heal(it->value);
-                std::cout << "You restored " << it->value << " health!\n";
+                Console::out() << "You restored " << it->value << " health!\n";
             } else if (it->name.find("Mana") != std::string::npos) {
                 restoreMana(it->value);
-                std::cout << "You restored " << it->value << " mana!\n";
+                Console::out() << "You restored " << it->value << " mana!\n";
             }
             removeItem(itemName);
+        } else if (it->isEquipment()) {
+            Item item = *it;
+            inventory.erase(it);
+            equip(item);
         } else {
-            std::cout << "You can't use that item here.\n";
+            Console::out() << "You can't use that item here.\n";
         }
     } else {
-        std::cout << "Item not found in inventory.\n";
+        Console::out() << "Item not found in inventory.\n";
     }
 }
 
-void Player::displayInventory() const {
-    std::cout << "\n" << Colors::BRIGHT_CYAN;
-    std::cout << "╔══════════════════════════════════════════════════╗\n";
-    std::cout << "║           🎒  INVENTORY  🎒                      ║\n";
-    std::cout << "╠══════════════════════════════════════════════════╣\n" << Colors::RESET;
+void Player::equip(const Item& item) {
+    Item& slot = (item.type == "weapon") ? weapon : armor;
+    
+    // Swap the old piece back into the bag
+    if (!slot.name.empty()) {
+        inventory.push_back(slot);
+        Console::out() << "You unequip " << slot.name << ".\n";
+    }
+    slot = item;
+    markStatsDirty();
     
+    Console::out() << "You equip " << item.name << " (+" << item.value
+              << (item.type == "weapon" ? " ATK" : " DEF") << ")!\n";
+}
+
+void Player::displayInventory() const {
+    Trace::Span span("Player::displayInventory");
+    static const Ui::Template header(std::string("\n") + Colors::BRIGHT_CYAN +
+        "╔══════════════════════════════════════════════════╗\n"
+        "║" + Ui::center("🎒 INVENTORY 🎒", 50).str() + "║\n"
+        "╠══════════════════════════════════════════════════╣\n" + Colors::RESET);
+    static const Ui::Template emptyRow(std::string(Colors::BRIGHT_CYAN) + "║  " + Colors::GRAY + "📭 (empty - no items)" +
+        Colors::BRIGHT_CYAN + "{@51}║\n");
+    // Icon, name, effect color, effect
+    static const Ui::Template itemRow(std::string(Colors::BRIGHT_CYAN) + "║  {}" + Colors::WHITE + "{22}{}{}" +
+        Colors::BRIGHT_CYAN + "{@51}║\n" + Colors::RESET);
+    // Equipped gear
+    static const Ui::Template footer(std::string(Colors::BRIGHT_CYAN) +
+        "╠══════════════════════════════════════════════════╣\n" +
+        Colors::BRIGHT_CYAN + "║  " + Colors::RED + "⚔️ Weapon: " + Colors::WHITE + "{}" + Colors::BRIGHT_CYAN + "{@51}║\n" +
+        Colors::BRIGHT_CYAN + "║  " + Colors::BLUE + "🛡️ Armor:  " + Colors::WHITE + "{}" + Colors::BRIGHT_CYAN + "{@51}║\n" +
+        Colors::BRIGHT_CYAN +
+        "╚══════════════════════════════════════════════════╝\n" + Colors::RESET);
+
+    header.render(Console::out());
     if (inventory.empty()) {
-        std::cout << Colors::BRIGHT_CYAN << "║  " << Colors::GRAY << "📭 (empty - no items)" 
-                  << std::string(25, ' ') << Colors::BRIGHT_CYAN << " ║\n";
-    } else {
-        for (const auto& item : inventory) {
-            std::cout << Colors::BRIGHT_CYAN << "║  ";
-            
-            // Icon based on item type
-            if (item.type == "potion") {
-                std::cout << "🧪 ";
-            } else if (item.type == "weapon") {
-                std::cout << "⚔️  ";
-            } else if (item.type == "armor") {
-                std::cout << "🛡️  ";
-            } else {
-                std::cout << "📦 ";
-            }
-            
-            std::cout << Colors::WHITE << std::left << std::setw(22) << item.name;
-            
-            if (item.type == "potion") {
-                std::string effect = "(+" + std::to_string(item.value) + " HP/MP)";
-                std::cout << Colors::GREEN << std::setw(15) << effect;
-            } else if (item.type == "weapon") {
-                std::string effect = "(+" + std::to_string(item.value) + " ATK)";
-                std::cout << Colors::RED << std::setw(15) << effect;
-            } else if (item.type == "armor") {
-                std::string effect = "(+" + std::to_string(item.value) + " DEF)";
-                std::cout << Colors::BLUE << std::setw(15) << effect;
-            } else {
-                std::cout << std::setw(15) << item.type;
-            }
-            
-            std::cout << Colors::BRIGHT_CYAN << " ║\n" << Colors::RESET;
+        emptyRow.render(Console::out());
+    }
+    for (const auto& item : inventory) {
+        // Icon and effect based on item type
+        Ui::Text effect;
+        if (item.type == "potion") {
+            effect << "(+" << item.value << " HP/MP)";
+            itemRow.render(Console::out(), {"🧪 ", item.name, Colors::GREEN, effect});
+        } else if (item.type == "weapon") {
+            effect << "(+" << item.value << " ATK)";
+            itemRow.render(Console::out(), {"⚔️ ", item.name, Colors::RED, effect});
+        } else if (item.type == "armor") {
+            effect << "(+" << item.value << " DEF)";
+            itemRow.render(Console::out(), {"🛡️ ", item.name, Colors::BLUE, effect});
+        } else {
+            itemRow.render(Console::out(), {"📦 ", item.name, "", item.type});
         }
     }
-    
-    std::cout << Colors::BRIGHT_CYAN;
-    std::cout << "╚══════════════════════════════════════════════════╝\n" << Colors::RESET;
+
+    Ui::Text weaponText;
+    if (weapon.name.empty()) {
+        weaponText << "(none)";
+    } else {
+        weaponText << weapon.name << " (+" << weapon.value << " ATK)";
+    }
+    Ui::Text armorText;
+    if (armor.name.empty()) {
+        armorText << "(none)";
+    } else {
+        armorText << armor.name << " (+" << armor.value << " DEF)";
+    }
+    footer.render(Console::out(), {weaponText, armorText});
 }
 
 bool Player::spendGold(int amount) {
@@ -251,32 +305,173 @@ bool Player::spendGold(int amount) {
     return false;
 }
 
-void Player::saveToFile(const std::string& filename) const {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not save game to " << filename << "\n";
-        return;
+static const uint32_t TAG_PLAYER = SaveFormat::makeTag("PLYR");
+static const uint32_t TAG_INVENTORY = SaveFormat::makeTag("INVT");
+static const uint32_t TAG_EQUIPMENT = SaveFormat::makeTag("EQUP");
+
+static void writeItem(SaveFormat::Writer& writer, const Item& item) {
+    writer.putString(item.name);
+    writer.putString(item.type);
+    writer.putI32(item.value);
+    writer.putI32(item.price);
+}
+
+static Item readItem(SaveFormat::Reader& reader) {
+    SaveFormat::StringView itemName = reader.getString();
+    SaveFormat::StringView itemType = reader.getString();
+    int itemValue = reader.getI32();
+    int itemPrice = reader.getI32();
+    if (itemName.size == 0) {
+        return Item();
     }
+    return Item(itemName.str(), itemType.str(), itemValue, itemPrice);
+}
+
+static void putTick(SaveFormat::Writer& writer, uint64_t tick) {
+    writer.putU32(static_cast<uint32_t>(tick & 0xFFFFFFFFu));
+    writer.putU32(static_cast<uint32_t>(tick >> 32));
+}
+
+static uint64_t getTick(SaveFormat::Reader& reader) {
+    uint64_t low = reader.getU32();
+    uint64_t high = reader.getU32();
+    return high << 32 | low;
+}
+
+void Player::writeSections(SaveFormat::Writer& writer, uint64_t worldTick) const {
+    writer.beginSection(TAG_PLAYER);
+    writer.putString(name);
+    writer.putU8(static_cast<uint8_t>(playerClass));
+    writer.putI32(level);
+    writer.putI32(experience);
+    writer.putI32(experienceToNext);
+    writer.putI32(health);
+    writer.putI32(maxHealth);
+    writer.putI32(mana);
+    writer.putI32(maxMana);
+    writer.putI32(strength);
+    writer.putI32(defense);
+    writer.putI32(agility);
+    writer.putI32(gold);
+    writer.putI32(x);
+    writer.putI32(y);
+    writer.putString(currentRegion);
+    putTick(writer, worldTick);
+    putTick(writer, regenTick);
+    writer.endSection();
     
-    file << name << "\n";
-    file << static_cast<int>(playerClass) << "\n";
-    file << level << " " << experience << " " << experienceToNext << "\n";
-    file << health << " " << maxHealth << "\n";
-    file << mana << " " << maxMana << "\n";
-    file << strength << " " << defense << " " << agility << "\n";
-    file << gold << "\n";
-    file << x << " " << y << "\n";
-    file << currentRegion << "\n";
-    file << inventory.size() << "\n";
+    writer.beginSection(TAG_INVENTORY);
+    writer.putU32(static_cast<uint32_t>(inventory.size()));
     for (const auto& item : inventory) {
-        file << item.name << "\n";  // Item name on its own line (may contain spaces)
-        file << item.type << " " << item.value << " " << item.price << "\n";
+        writeItem(writer, item);
     }
+    writer.endSection();
     
-    file.close();
+    writer.beginSection(TAG_EQUIPMENT);
+    writeItem(writer, weapon);
+    writeItem(writer, armor);
+    writer.endSection();
+}
+
+bool Player::readSections(const SaveFormat::SaveFile& save, uint64_t* worldTick) {
+    if (!save.hasSection(TAG_PLAYER)) {
+        return false;
+    }
+    
+    SaveFormat::Reader stats(save.getSection(TAG_PLAYER));
+    std::string loadedName = stats.getString().str();
+    int classInt = stats.getU8();
+    int values[13];
+    for (int& value : values) {
+        value = stats.getI32();
+    }
+    std::string loadedRegion = stats.getString().str();
+    if (!stats.ok() || classInt > static_cast<int>(PlayerClass::ARCHER)) {
+        return false;
+    }
+    // Older saves end here
+    uint64_t savedTick = 0;
+    uint64_t savedRegenTick = 0;
+    if (!stats.atEnd()) {
+        savedTick = getTick(stats);
+        savedRegenTick = getTick(stats);
+        if (!stats.ok()) {
+            return false;
+        }
+    }
+    
+    name = loadedName;
+    playerClass = static_cast<PlayerClass>(classInt);
+    initializeSkills();
+    level = values[0];
+    experience = values[1];
+    experienceToNext = values[2];
+    health = values[3];
+    maxHealth = values[4];
+    mana = values[5];
+    maxMana = values[6];
+    strength = values[7];
+    defense = values[8];
+    agility = values[9];
+    gold = values[10];
+    x = values[11];
+    y = values[12];
+    currentRegion = loadedRegion;
+    regenTick = savedRegenTick;
+    if (worldTick) {
+        *worldTick = savedTick;
+    }
+    
+    inventory.clear();
+    if (save.hasSection(TAG_INVENTORY)) {
+        SaveFormat::Reader items(save.getSection(TAG_INVENTORY));
+        uint32_t count = items.getU32();
+        for (uint32_t i = 0; i < count && items.ok(); i++) {
+            Item item = readItem(items);
+            if (items.ok()) {
+                inventory.push_back(item);
+            }
+        }
+    }
+    
+    weapon = Item();
+    armor = Item();
+    if (save.hasSection(TAG_EQUIPMENT)) {
+        SaveFormat::Reader gear(save.getSection(TAG_EQUIPMENT));
+        Item loadedWeapon = readItem(gear);
+        Item loadedArmor = readItem(gear);
+        if (gear.ok()) {
+            weapon = loadedWeapon;
+            armor = loadedArmor;
+        }
+    }
+    markStatsDirty();
+    return true;
+}
+
+void Player::saveToFile(const std::string& filename) const {
+    SaveFormat::Writer writer;
+    writeSections(writer);
+    if (!writer.writeToFile(filename)) {
+        std::cerr << "Error: Could not save game to " << filename << "\n";
+    }
 }
 
 bool Player::loadFromFile(const std::string& filename) {
+    if (!SaveFormat::isBinarySave(filename)) {
+        return loadLegacyText(filename);
+    }
+    
+    SaveFormat::SaveFile save;
+    if (!save.open(filename)) {
+        std::cerr << "Error: Could not load " << filename << ": " << save.getError() << "\n";
+        return false;
+    }
+    return readSections(save);
+}
+
+// Pre-binary line-oriented format, still read so old saves migrate forward
+bool Player::loadLegacyText(const std::string& filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
         return false;
@@ -320,67 +515,79 @@ bool Player::loadFromFile(const std::string& filename) {
         inventory.push_back(Item(itemName, itemType, itemValue, itemPrice));
     }
     
+    // Read equipment (older saves end here and leave both slots empty)
+    weapon = Item();
+    armor = Item();
+    const char* slotTypes[] = {"weapon", "armor"};
+    Item* slots[] = {&weapon, &armor};
+    for (int i = 0; i < 2; i++) {
+        std::string slotName;
+        int slotValue, slotPrice;
+        if (!std::getline(file, slotName) || !(file >> slotValue >> slotPrice)) {
+            break;
+        }
+        file.ignore(); // Skip newline
+        if (slotName != "-") {
+            *slots[i] = Item(slotName, slotTypes[i], slotValue, slotPrice);
+        }
+    }
+    markStatsDirty();
+    
     file.close();
     return true;
 }
 
 void Player::displayStats() const {
-    std::cout << "\n" << Colors::BRIGHT_CYAN;
-    std::cout << "╔══════════════════════════════════════════════════╗\n";
-    std::cout << "║          📜 CHARACTER SHEET 📜                   ║\n";
-    std::cout << "╠══════════════════════════════════════════════════╣\n" << Colors::RESET;
-    
-    // Name and Class with class icons
-    std::cout << Colors::BRIGHT_CYAN << "║ " << Colors::BRIGHT_GREEN << "👤 Name : " << Colors::WHITE 
-              << std::left << std::setw(37) << name << Colors::BRIGHT_CYAN << " ║\n";
-    
-    std::string className = getClassName();
-    std::string classIcon;
-    if (className == "Warrior") classIcon = "⚔️  Warrior";
-    else if (className == "Mage") classIcon = "🔮 Mage";
-    else classIcon = "🏹 Archer";
-    
-    std::cout << Colors::BRIGHT_CYAN << "║ " << Colors::BRIGHT_GREEN << "   Class: " << Colors::WHITE 
-              << std::left << std::setw(37) << classIcon << Colors::BRIGHT_CYAN << " ║\n";
-    std::cout << Colors::BRIGHT_CYAN << "║ " << Colors::BRIGHT_GREEN << "⭐ Level: " << Colors::BRIGHT_YELLOW 
-              << std::left << std::setw(37) << level << Colors::BRIGHT_CYAN << " ║\n";
-    
-    std::cout << Colors::BRIGHT_CYAN << "╠══════════════════════════════════════════════════╣\n" << Colors::RESET;
-    
-    // Health Bar
-    std::string hpBar = Colors::healthBar(health, maxHealth, 25);
-    std::string hpText = std::to_string(health) + "/" + std::to_string(maxHealth);
-    std::cout << Colors::BRIGHT_CYAN << "║ " << Colors::BRIGHT_RED << "❤️  HP: " << hpBar 
-              << Colors::WHITE << " " << std::left << std::setw(7) << hpText << Colors::BRIGHT_CYAN << " ║\n";
-              
-    // Mana Bar
-    std::string mpBar = Colors::manaBar(mana, maxMana, 25);
-    std::string mpText = std::to_string(mana) + "/" + std::to_string(maxMana);
-    std::cout << Colors::BRIGHT_CYAN << "║ " << Colors::BRIGHT_BLUE << "💙 MP: " << mpBar 
-              << Colors::WHITE << " " << std::left << std::setw(7) << mpText << Colors::BRIGHT_CYAN << " ║\n";
-    
-    // XP
-    std::string xpText = std::to_string(experience) + " / " + std::to_string(experienceToNext);
-    std::cout << Colors::BRIGHT_CYAN << "║ " << Colors::BRIGHT_CYAN << "✨ XP: " << Colors::YELLOW 
-              << std::left << std::setw(40) << xpText << Colors::BRIGHT_CYAN << " ║\n";
-              
-    std::cout << Colors::BRIGHT_CYAN << "╠══════════════════════════════════════════════════╣\n" << Colors::RESET;
-    
-    // Attributes
-    std::cout << Colors::BRIGHT_CYAN << "║ " << Colors::BRIGHT_YELLOW << "⚡ ATTRIBUTES:                                    " << Colors::BRIGHT_CYAN << "║\n";
-    std::cout << Colors::BRIGHT_CYAN << "║   " << Colors::RED << "💪 STR: " << Colors::WHITE << std::left << std::setw(4) << strength 
-              << Colors::BLUE << "🛡️  DEF: " << Colors::WHITE << std::left << std::setw(4) << defense 
-              << Colors::GREEN << "🏃 AGI: " << Colors::WHITE << std::left << std::setw(4) << agility 
-              << "           " << Colors::BRIGHT_CYAN << "║\n";
-              
-    std::cout << Colors::BRIGHT_CYAN << "╠══════════════════════════════════════════════════╣\n" << Colors::RESET;
-    
-    // Gold and Location
-    std::cout << Colors::BRIGHT_CYAN << "║ " << Colors::YELLOW << "💰 Gold: " << Colors::WHITE << std::left << std::setw(8) << gold 
-              << Colors::CYAN << "📍 Location: " << Colors::WHITE << std::left << std::setw(17) << currentRegion.substr(0, 17) 
-              << Colors::BRIGHT_CYAN << " ║\n";
-              
-    std::cout << Colors::BRIGHT_CYAN << "╚══════════════════════════════════════════════════╝\n" << Colors::RESET;
+    Trace::Span span("Player::displayStats");
+    // The sheet is drawn once into a template; only the values change
+    static const Ui::Template sheet(std::string("\n") + Colors::BRIGHT_CYAN +
+        "╔══════════════════════════════════════════════════╗\n"
+        "║" + Ui::center("📜 CHARACTER SHEET 📜", 50).str() + "║\n"
+        "╠══════════════════════════════════════════════════╣\n" + Colors::RESET +
+        // Name and Class with class icons
+        Colors::BRIGHT_CYAN + "║ " + Colors::BRIGHT_GREEN + "👤 Name : " + Colors::WHITE + "{}" + Colors::BRIGHT_CYAN + "{@51}║\n" +
+        Colors::BRIGHT_CYAN + "║ " + Colors::BRIGHT_GREEN + "   Class: " + Colors::WHITE + "{}" + Colors::BRIGHT_CYAN + "{@51}║\n" +
+        Colors::BRIGHT_CYAN + "║ " + Colors::BRIGHT_GREEN + "⭐ Level: " + Colors::BRIGHT_YELLOW + "{}" + Colors::BRIGHT_CYAN + "{@51}║\n" +
+        Colors::BRIGHT_CYAN + "╠══════════════════════════════════════════════════╣\n" + Colors::RESET +
+        // Health, Mana and XP
+        Colors::BRIGHT_CYAN + "║ " + Colors::BRIGHT_RED + "❤️ HP: {}" + Colors::WHITE + " {}" + Colors::BRIGHT_CYAN + "{@51}║\n" +
+        Colors::BRIGHT_CYAN + "║ " + Colors::BRIGHT_BLUE + "💙 MP: {}" + Colors::WHITE + " {}" + Colors::BRIGHT_CYAN + "{@51}║\n" +
+        Colors::BRIGHT_CYAN + "║ " + Colors::BRIGHT_CYAN + "✨ XP: " + Colors::YELLOW + "{}" + Colors::BRIGHT_CYAN + "{@51}║\n" +
+        Colors::BRIGHT_CYAN + "╠══════════════════════════════════════════════════╣\n" + Colors::RESET +
+        // Attributes
+        Colors::BRIGHT_CYAN + "║ " + Colors::BRIGHT_YELLOW + "⚡ ATTRIBUTES:" + Colors::BRIGHT_CYAN + "{@51}║\n" +
+        Colors::BRIGHT_CYAN + "║   " + Colors::RED + "💪 STR: " + Colors::WHITE + "{4}" + Colors::BLUE + "🛡️ DEF: " + Colors::WHITE + "{4}" +
+            Colors::GREEN + "🏃 AGI: " + Colors::WHITE + "{4}" + Colors::BRIGHT_CYAN + "{@51}║\n" +
+        Colors::BRIGHT_CYAN + "║   " + Colors::BRIGHT_RED + "🗡️ ATK: " + Colors::WHITE + "{4}" + Colors::BRIGHT_BLUE + "🛡️ ARM: " + Colors::WHITE +
+            "{4}" + Colors::BRIGHT_CYAN + "{@51}║\n" +
+        Colors::BRIGHT_CYAN + "╠══════════════════════════════════════════════════╣\n" + Colors::RESET +
+        // Gold and Location
+        Colors::BRIGHT_CYAN + "║ " + Colors::YELLOW + "💰 Gold: " + Colors::WHITE + "{8}" + Colors::CYAN + "📍 Location: " + Colors::WHITE + "{}" +
+            Colors::BRIGHT_CYAN + "{@51}║\n" +
+        Colors::BRIGHT_CYAN + "╚══════════════════════════════════════════════════╝\n" + Colors::RESET);
+
+    const char* classIcon;
+    switch (playerClass) {
+        case PlayerClass::WARRIOR: classIcon = "⚔️ Warrior"; break;
+        case PlayerClass::MAGE: classIcon = "🔮 Mage"; break;
+        default: classIcon = "🏹 Archer"; break;
+    }
+
+    Ui::Text hpText;
+    hpText << health << '/' << maxHealth;
+    Ui::Text mpText;
+    mpText << mana << '/' << maxMana;
+    Ui::Text xpText;
+    xpText << experience << " / " << experienceToNext;
+    sheet.render(Console::out(), {
+        name, classIcon, level,
+        Colors::healthBarView(health, maxHealth, 25), hpText,
+        Colors::manaBarView(mana, maxMana, 25), mpText,
+        xpText,
+        strength, defense, agility,
+        getAttackPower(), getDefensePower(),
+        gold, Ui::Value(currentRegion.data(), std::min<size_t>(currentRegion.size(), 17))
+    });
 }
 
 std::string Player::getClassName() const {
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include <map>
+#include "SaveFormat.h"
+#include <cstdint>
 
 enum class PlayerClass {
     WARRIOR,
@@ -18,8 +20,11 @@ public:
     int value;
     int price;
     
+    Item() : value(0), price(0) {}
     Item(const std::string& n, const std::string& t, int v, int p) 
         : name(n), type(t), value(v), price(p) {}
+    
+    bool isEquipment() const { return type == "weapon" || type == "armor"; }
 };
 
 struct Skill {
@@ -53,9 +58,23 @@ private:
     std::vector<Item> inventory;
     std::vector<Skill> skills;
     std::string currentRegion;
+    uint64_t regenTick; // world tick passive regen was last applied up to
+    
+    // Equipment slots (an empty name means nothing is equipped)
+    Item weapon;
+    Item armor;
+    
+    // Derived combat stats: base stats plus gear, rebuilt only when
+    // equipment or level changes so attack()/defend() stay cheap.
+    mutable bool statsDirty;
+    mutable int attackPower;
+    mutable int defensePower;
     
     void initializeStats();
     void initializeSkills();
+    void refreshDerivedStats() const;
+    bool loadLegacyText(const std::string& filename);
+    void markStatsDirty() { statsDirty = true; }
 
 public:
     Player(const std::string& playerName, PlayerClass pClass);
@@ -76,6 +95,10 @@ public:
     int getY() const { return y; }
     int getExperience() const { return experience; }
     int getExperienceToNext() const { return experienceToNext; }
+    int getAttackPower() const { if (statsDirty) refreshDerivedStats(); return attackPower; }
+    int getDefensePower() const { if (statsDirty) refreshDerivedStats(); return defensePower; }
+    const Item& getWeapon() const { return weapon; }
+    const Item& getArmor() const { return armor; }
     std::string getCurrentRegion() const { return currentRegion; }
     const std::vector<Skill>& getSkills() const { return skills; }
     
@@ -90,6 +113,11 @@ public:
     void takeDamage(int damage);
     void heal(int amount);
     void restoreMana(int amount);
+    // Passive regen for the world ticks since the last call (~2% of max
+    // HP per tick); returns the HP recovered
+    int regenerate(uint64_t now);
+    // Health once regen up to `now` is applied, without applying it
+    int healthAt(uint64_t now) const;
     
     // Leveling
     void gainExperience(int exp);
@@ -100,6 +128,9 @@ public:
     bool removeItem(const std::string& itemName);
     void useItem(const std::string& itemName);
     void displayInventory() const;
+    
+    // Equipment
+    void equip(const Item& item);
     std::vector<Item> getInventory() const { return inventory; }
     
     // Economy
@@ -108,7 +139,11 @@ public:
     
     // Save/Load
     void saveToFile(const std::string& filename) const;
-    bool loadFromFile(const std::string& filename);
+    bool loadFromFile(const std::string& filename); // binary, or legacy text
+    // The PLYR section also keeps the world tick the save was made at, so
+    // regen resumes from where it was; saves without it read as tick 0
+    void writeSections(SaveFormat::Writer& writer, uint64_t worldTick = 0) const;
+    bool readSections(const SaveFormat::SaveFile& save, uint64_t* worldTick = nullptr);
     
     // Display
     void displayStats() const;
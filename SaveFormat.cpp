@@ -0,0 +1,321 @@
+#include "SaveFormat.h"
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace SaveFormat {
+
+    static const char MAGIC[4] = {'A', 'R', 'K', 'S'};
+    static const size_t HEADER_SIZE = 12;         // magic + version + reserved + count
+    static const size_t V1_HEADER_SIZE = 8;       // magic + version + u16 count
+    static const size_t SECTION_HEADER_SIZE = 16; // tag + key + length + crc
+    static const size_t V1_SECTION_HEADER_SIZE = 12; // no key
+
+    static uint32_t readU32(const char* p) {
+        const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+        return static_cast<uint32_t>(b[0]) | static_cast<uint32_t>(b[1]) << 8 |
+               static_cast<uint32_t>(b[2]) << 16 | static_cast<uint32_t>(b[3]) << 24;
+    }
+
+    static uint16_t readU16(const char* p) {
+        const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+        return static_cast<uint16_t>(b[0] | b[1] << 8);
+    }
+
+    static void writeU32At(std::string& buffer, size_t offset, uint32_t value) {
+        buffer[offset] = static_cast<char>(value & 0xFF);
+        buffer[offset + 1] = static_cast<char>((value >> 8) & 0xFF);
+        buffer[offset + 2] = static_cast<char>((value >> 16) & 0xFF);
+        buffer[offset + 3] = static_cast<char>((value >> 24) & 0xFF);
+    }
+
+    // Standard reflected CRC-32 (poly 0xEDB88320) lookup table
+    struct CrcTable {
+        uint32_t entries[256];
+
+        CrcTable() {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                entries[i] = c;
+            }
+        }
+    };
+
+    uint32_t crc32(const char* data, size_t length) {
+        static const CrcTable table;
+        uint32_t crc = 0xFFFFFFFFu;
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < length; i++) {
+            crc = table.entries[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    bool StringView::operator==(const char* other) const {
+        return std::strlen(other) == size && std::memcmp(data, other, size) == 0;
+    }
+
+    // ---------------------------------------------------------------- Writer
+
+    Writer::Writer() : sectionCount(0), sectionStart(0) {
+        buffer.append(MAGIC, 4);
+        putU16(VERSION);
+        putU16(0); // reserved
+        putU32(0); // section count, patched in finish()
+    }
+
+    void Writer::beginSection(uint32_t tag, uint32_t key) {
+        putU32(tag);
+        putU32(key);
+        putU32(0); // length, patched in endSection()
+        putU32(0); // crc, patched in endSection()
+        sectionStart = buffer.size();
+    }
+
+    void Writer::endSection() {
+        size_t length = buffer.size() - sectionStart;
+        writeU32At(buffer, sectionStart - 8, static_cast<uint32_t>(length));
+        writeU32At(buffer, sectionStart - 4, crc32(buffer.data() + sectionStart, length));
+        sectionCount++;
+    }
+
+    void Writer::putU8(uint8_t value) {
+        buffer.push_back(static_cast<char>(value));
+    }
+
+    void Writer::putU16(uint16_t value) {
+        buffer.push_back(static_cast<char>(value & 0xFF));
+        buffer.push_back(static_cast<char>((value >> 8) & 0xFF));
+    }
+
+    void Writer::putU32(uint32_t value) {
+        char bytes[4];
+        bytes[0] = static_cast<char>(value & 0xFF);
+        bytes[1] = static_cast<char>((value >> 8) & 0xFF);
+        bytes[2] = static_cast<char>((value >> 16) & 0xFF);
+        bytes[3] = static_cast<char>((value >> 24) & 0xFF);
+        buffer.append(bytes, 4);
+    }
+
+    void Writer::putString(const std::string& value) {
+        putU32(static_cast<uint32_t>(value.size()));
+        buffer.append(value);
+    }
+
+    void Writer::putBytes(const char* data, size_t length) {
+        buffer.append(data, length);
+    }
+
+    const std::string& Writer::finish() {
+        writeU32At(buffer, 8, sectionCount);
+        return buffer;
+    }
+
+    bool Writer::writeToFile(const std::string& filename) {
+        const std::string& image = finish();
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(image.data(), image.size());
+        return static_cast<bool>(file);
+    }
+
+    // ---------------------------------------------------------------- Reader
+
+    Reader::Reader(StringView payload)
+        : pos(payload.data), end(payload.data + payload.size), failed(false) {}
+
+    bool Reader::need(size_t bytes) {
+        if (failed || static_cast<size_t>(end - pos) < bytes) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    uint8_t Reader::getU8() {
+        if (!need(1)) return 0;
+        return static_cast<uint8_t>(*pos++);
+    }
+
+    uint16_t Reader::getU16() {
+        if (!need(2)) return 0;
+        uint16_t value = readU16(pos);
+        pos += 2;
+        return value;
+    }
+
+    uint32_t Reader::getU32() {
+        if (!need(4)) return 0;
+        uint32_t value = readU32(pos);
+        pos += 4;
+        return value;
+    }
+
+    StringView Reader::getString() {
+        uint32_t length = getU32();
+        return getBytes(length);
+    }
+
+    StringView Reader::getBytes(size_t length) {
+        if (!need(length)) return StringView();
+        StringView view(pos, length);
+        pos += length;
+        return view;
+    }
+
+    // -------------------------------------------------------------- SaveFile
+
+    SaveFile::SaveFile() : mapping(nullptr), mappingSize(0), version(0) {}
+
+    SaveFile::~SaveFile() {
+        release();
+    }
+
+    void SaveFile::release() {
+        if (mapping) {
+            munmap(mapping, mappingSize);
+            mapping = nullptr;
+            mappingSize = 0;
+        }
+        std::vector<char>().swap(fallback);
+        sections.clear();
+        version = 0;
+    }
+
+    bool SaveFile::open(const std::string& filename) {
+        release();
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = "could not open " + filename;
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(V1_HEADER_SIZE)) {
+            ::close(fd);
+            error = "not a binary save";
+            return false;
+        }
+
+        size_t size = static_cast<size_t>(st.st_size);
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        const char* data;
+        if (mapped != MAP_FAILED) {
+            mapping = mapped;
+            mappingSize = size;
+            data = static_cast<const char*>(mapped);
+        } else {
+            // Some filesystems can't be mapped; fall back to a single read
+            fallback.resize(size);
+            ssize_t got = pread(fd, fallback.data(), size, 0);
+            if (got != static_cast<ssize_t>(size)) {
+                ::close(fd);
+                error = "short read on " + filename;
+                return false;
+            }
+            data = fallback.data();
+        }
+        ::close(fd);
+
+        return parse(data, size);
+    }
+
+    bool SaveFile::parseBuffer(const char* data, size_t size) {
+        release();
+        return parse(data, size);
+    }
+
+    bool SaveFile::parse(const char* data, size_t size) {
+        sections.clear();
+        if (size < V1_HEADER_SIZE || std::memcmp(data, MAGIC, 4) != 0) {
+            error = "not a binary save";
+            return false;
+        }
+
+        version = readU16(data + 4);
+        if (version == 0 || version > VERSION) {
+            error = "unsupported save version " + std::to_string(version);
+            return false;
+        }
+
+        uint32_t count;
+        size_t offset;
+        size_t headerSize;
+        if (version == 1) {
+            count = readU16(data + 6);
+            offset = V1_HEADER_SIZE;
+            headerSize = V1_SECTION_HEADER_SIZE;
+        } else {
+            if (size < HEADER_SIZE) {
+                error = "truncated header";
+                return false;
+            }
+            count = readU32(data + 8);
+            offset = HEADER_SIZE;
+            headerSize = SECTION_HEADER_SIZE;
+        }
+        sections.reserve(std::min<size_t>(count, (size - offset) / headerSize));
+        for (uint32_t i = 0; i < count; i++) {
+            if (size - offset < headerSize) {
+                error = "truncated section header";
+                return false;
+            }
+            const char* header = data + offset;
+            uint32_t tag = readU32(header);
+            uint32_t key = 0;
+            if (version >= 2) {
+                key = readU32(header + 4);
+                header += 4;
+            }
+            uint32_t length = readU32(header + 4);
+            uint32_t crc = readU32(header + 8);
+            offset += headerSize;
+
+            if (size - offset < length) {
+                error = "truncated section payload";
+                return false;
+            }
+            if (crc32(data + offset, length) != crc) {
+                error = "checksum mismatch";
+                return false;
+            }
+
+            Section section;
+            section.tag = tag;
+            section.key = key;
+            section.payload = StringView(data + offset, length);
+            sections.push_back(section);
+            offset += length;
+        }
+        return true;
+    }
+
+    bool SaveFile::hasSection(uint32_t tag, uint32_t key) const {
+        for (const auto& section : sections) {
+            if (section.tag == tag && section.key == key) return true;
+        }
+        return false;
+    }
+
+    StringView SaveFile::getSection(uint32_t tag, uint32_t key) const {
+        for (const auto& section : sections) {
+            if (section.tag == tag && section.key == key) return section.payload;
+        }
+        return StringView();
+    }
+
+    bool isBinarySave(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        char magic[4];
+        return file.read(magic, 4) && std::memcmp(magic, MAGIC, 4) == 0;
+    }
+}
@@ -0,0 +1,140 @@
+#ifndef SAVEFORMAT_H
+#define SAVEFORMAT_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Binary save file layout (all integers little-endian):
+//
+//   header:  "ARKS" magic, u16 version, u16 reserved, u32 section count
+//   section: u32 tag, u32 key, u32 payload length, u32 CRC-32 of payload,
+//            payload
+//
+// Sections are looked up by (tag, key), so readers skip tags they don't
+// know and new data can be added without breaking older files. The key
+// lets one tag repeat, e.g. one map chunk section per chunk.
+//
+// Version history:
+//   1 - u16 section count, section header without the key (read as key 0)
+//   2 - keyed sections, u32 section count
+namespace SaveFormat {
+    const uint16_t VERSION = 2;
+
+    // Build a section tag from four characters, e.g. makeTag("PLYR")
+    constexpr uint32_t makeTag(const char (&t)[5]) {
+        return static_cast<uint32_t>(static_cast<unsigned char>(t[0])) |
+               static_cast<uint32_t>(static_cast<unsigned char>(t[1])) << 8 |
+               static_cast<uint32_t>(static_cast<unsigned char>(t[2])) << 16 |
+               static_cast<uint32_t>(static_cast<unsigned char>(t[3])) << 24;
+    }
+
+    uint32_t crc32(const char* data, size_t length);
+
+    // Non-owning view into a loaded save buffer
+    struct StringView {
+        const char* data;
+        size_t size;
+
+        StringView() : data(nullptr), size(0) {}
+        StringView(const char* d, size_t s) : data(d), size(s) {}
+        std::string str() const { return std::string(data, size); }
+        bool operator==(const char* other) const;
+    };
+
+    // Serializes sections into one contiguous buffer
+    class Writer {
+    private:
+        std::string buffer;
+        uint32_t sectionCount;
+        size_t sectionStart;
+
+    public:
+        Writer();
+
+        void beginSection(uint32_t tag, uint32_t key = 0);
+        void endSection();
+
+        void putU8(uint8_t value);
+        void putU16(uint16_t value);
+        void putU32(uint32_t value);
+        void putI32(int32_t value) { putU32(static_cast<uint32_t>(value)); }
+        void putString(const std::string& value);
+        void putBytes(const char* data, size_t length);
+
+        // Finished file image (header patched with the section count)
+        const std::string& finish();
+        bool writeToFile(const std::string& filename);
+    };
+
+    // Bounds-checked cursor over one section payload. Any overrun sets
+    // the failed flag and makes every further read return zero values.
+    class Reader {
+    private:
+        const char* pos;
+        const char* end;
+        bool failed;
+
+        bool need(size_t bytes);
+
+    public:
+        Reader(StringView payload);
+
+        uint8_t getU8();
+        uint16_t getU16();
+        uint32_t getU32();
+        int32_t getI32() { return static_cast<int32_t>(getU32()); }
+        StringView getString();
+        StringView getBytes(size_t length);
+
+        bool ok() const { return !failed; }
+        bool atEnd() const { return pos == end; }
+    };
+
+    // A save file loaded with a single mmap (or read) and validated up
+    // front. Section payloads are views into the mapping and stay valid
+    // until the SaveFile is destroyed or opens or parses another image.
+    class SaveFile {
+    public:
+        struct Section {
+            uint32_t tag;
+            uint32_t key;
+            StringView payload;
+        };
+
+    private:
+        void* mapping;
+        size_t mappingSize;
+        std::vector<char> fallback; // used when the file can't be mapped
+        std::vector<Section> sections;
+        uint16_t version;
+        std::string error;
+
+        void release(); // drop the previous file and its sections
+        bool parse(const char* data, size_t size);
+
+    public:
+        SaveFile();
+        ~SaveFile();
+        SaveFile(const SaveFile&) = delete;
+        SaveFile& operator=(const SaveFile&) = delete;
+
+        // Returns false if the file is missing, not a binary save, from a
+        // newer version, or fails a checksum; see getError().
+        bool open(const std::string& filename);
+        // Parse an image already in memory; the caller keeps it alive
+        bool parseBuffer(const char* data, size_t size);
+
+        bool hasSection(uint32_t tag, uint32_t key = 0) const;
+        StringView getSection(uint32_t tag, uint32_t key = 0) const;
+        const std::vector<Section>& getSections() const { return sections; }
+        uint16_t getVersion() const { return version; }
+        const std::string& getError() const { return error; }
+    };
+
+    // True if the file starts with the binary save magic
+    bool isBinarySave(const std::string& filename);
+}
+
+#endif
@@ -0,0 +1,411 @@
+#include "SaveStore.h"
+#include "SaveFormat.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+
+// File header: "ARKD", u32 version, u64 offset of the first directory block
+static const char STORE_MAGIC[4] = {'A', 'R', 'K', 'D'};
+static const uint32_t STORE_VERSION = 1;
+static const uint64_t ALIGN = 256;
+static const uint64_t HEADER_EXTENT = ALIGN;
+
+// Directory block: "DIRB", u32 entry count, u64 next block, padded to 128
+// bytes so every 128-byte entry sits inside a single disk sector
+static const char BLOCK_MAGIC[4] = {'D', 'I', 'R', 'B'};
+static const uint32_t ENTRIES_PER_BLOCK = 256;
+static const uint64_t BLOCK_HEADER_SIZE = 128;
+static const uint64_t ENTRY_SIZE = 128;
+static const uint64_t BLOCK_SIZE = BLOCK_HEADER_SIZE + ENTRIES_PER_BLOCK * ENTRY_SIZE;
+
+// Entry: u32 CRC of bytes 4..127, u8 used, u8 name length, u16 reserved,
+// u64 record offset, u32 length, u32 capacity, u32 record CRC,
+// u32 generation, name bytes
+static const size_t ENTRY_NAME_OFFSET = 32;
+
+static uint64_t roundUp(uint64_t size) {
+    return std::max(ALIGN, (size + ALIGN - 1) / ALIGN * ALIGN);
+}
+
+static void put32(char* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+static void put64(char* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+static uint32_t get32(const char* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= static_cast<uint32_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    return value;
+}
+
+static uint64_t get64(const char* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    return value;
+}
+
+static bool writeAt(int fd, const char* data, size_t length, uint64_t offset) {
+    while (length > 0) {
+        ssize_t written = pwrite(fd, data, length, static_cast<off_t>(offset));
+        if (written < 0) return false;
+        data += written;
+        length -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return true;
+}
+
+static bool readAt(int fd, char* data, size_t length, uint64_t offset) {
+    while (length > 0) {
+        ssize_t got = pread(fd, data, length, static_cast<off_t>(offset));
+        if (got <= 0) return false;
+        data += got;
+        length -= static_cast<size_t>(got);
+        offset += static_cast<uint64_t>(got);
+    }
+    return true;
+}
+
+SaveStore::SaveStore(const std::string& filename) : path(filename), fd(-1), fileEnd(0) {
+    // glibc defaults to preferring readers, which can starve put() while
+    // other threads keep loading
+    pthread_rwlockattr_t attributes;
+    pthread_rwlockattr_init(&attributes);
+#ifdef __GLIBC__
+    pthread_rwlockattr_setkind_np(&attributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    pthread_rwlock_init(&indexLock, &attributes);
+    pthread_rwlockattr_destroy(&attributes);
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        setError("could not open " + path);
+        return;
+    }
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        setError("save store in use: " + path + " is open in another process");
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0 && (st.st_size == 0 ? create() : load());
+    if (!ok) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+SaveStore::~SaveStore() {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    pthread_rwlock_destroy(&indexLock);
+}
+
+void SaveStore::setError(const std::string& message) {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    error = message;
+}
+
+std::string SaveStore::getError() const {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    return error;
+}
+
+bool SaveStore::create() {
+    char header[HEADER_EXTENT] = {};
+    std::memcpy(header, STORE_MAGIC, 4);
+    put32(header + 4, STORE_VERSION);
+    if (!writeAt(fd, header, sizeof(header), 0)) {
+        setError("could not initialize " + path);
+        return false;
+    }
+    fileEnd = HEADER_EXTENT;
+    return addDirectoryBlock();
+}
+
+bool SaveStore::load() {
+    char header[16];
+    if (!readAt(fd, header, sizeof(header), 0) || std::memcmp(header, STORE_MAGIC, 4) != 0) {
+        setError(path + " is not a save store");
+        return false;
+    }
+    if (get32(header + 4) > STORE_VERSION) {
+        setError(path + " was written by a newer version");
+        return false;
+    }
+
+    // Every byte not claimed by the header, a directory block or a live
+    // record is free space
+    std::map<uint64_t, uint64_t> used;
+    used[0] = HEADER_EXTENT;
+
+    std::vector<char> block(BLOCK_SIZE);
+    uint64_t blockOffset = get64(header + 8);
+    while (blockOffset != 0) {
+        if (!readAt(fd, block.data(), BLOCK_SIZE, blockOffset) ||
+            std::memcmp(block.data(), BLOCK_MAGIC, 4) != 0 ||
+            used.count(blockOffset)) {
+            setError("damaged directory in " + path);
+            return false;
+        }
+        uint32_t base = static_cast<uint32_t>(directoryBlocks.size()) * ENTRIES_PER_BLOCK;
+        directoryBlocks.push_back(blockOffset);
+        used[blockOffset] = roundUp(BLOCK_SIZE);
+
+        for (uint32_t i = 0; i < ENTRIES_PER_BLOCK; i++) {
+            const char* entry = block.data() + BLOCK_HEADER_SIZE + i * ENTRY_SIZE;
+            size_t nameLength = static_cast<unsigned char>(entry[5]);
+            bool live = entry[4] == 1 && nameLength > 0 && nameLength <= MAX_PROFILE_NAME &&
+                        get32(entry) == SaveFormat::crc32(entry + 4, ENTRY_SIZE - 4);
+            if (!live) {
+                freeEntries.push_back(base + i);
+                continue;
+            }
+            Slot slot;
+            slot.entryIndex = base + i;
+            slot.offset = get64(entry + 8);
+            slot.length = get32(entry + 16);
+            slot.capacity = get32(entry + 20);
+            slot.recordCrc = get32(entry + 24);
+            slot.generation = get32(entry + 28);
+            index[std::string(entry + ENTRY_NAME_OFFSET, nameLength)] = slot;
+            used[slot.offset] = slot.capacity;
+        }
+        blockOffset = get64(block.data() + 8);
+    }
+    // Hand out low entries first
+    std::reverse(freeEntries.begin(), freeEntries.end());
+
+    uint64_t cursor = 0;
+    for (const auto& extent : used) {
+        if (extent.first > cursor) {
+            release(cursor, extent.first - cursor);
+        }
+        cursor = std::max(cursor, extent.first + extent.second);
+    }
+    fileEnd = cursor;
+    return true;
+}
+
+uint64_t SaveStore::entryPosition(uint32_t entryIndex) const {
+    return directoryBlocks[entryIndex / ENTRIES_PER_BLOCK] + BLOCK_HEADER_SIZE +
+           (entryIndex % ENTRIES_PER_BLOCK) * ENTRY_SIZE;
+}
+
+bool SaveStore::writeEntry(uint32_t entryIndex, const std::string& profile, const Slot* slot) {
+    char entry[ENTRY_SIZE] = {};
+    if (slot) {
+        entry[4] = 1;
+        entry[5] = static_cast<char>(profile.size());
+        put64(entry + 8, slot->offset);
+        put32(entry + 16, slot->length);
+        put32(entry + 20, slot->capacity);
+        put32(entry + 24, slot->recordCrc);
+        put32(entry + 28, slot->generation);
+        std::memcpy(entry + ENTRY_NAME_OFFSET, profile.data(), profile.size());
+    }
+    put32(entry, SaveFormat::crc32(entry + 4, ENTRY_SIZE - 4));
+    return writeAt(fd, entry, ENTRY_SIZE, entryPosition(entryIndex)) && fsync(fd) == 0;
+}
+
+bool SaveStore::addDirectoryBlock() {
+    uint64_t offset = allocate(roundUp(BLOCK_SIZE));
+    std::vector<char> block(BLOCK_SIZE, 0);
+    std::memcpy(block.data(), BLOCK_MAGIC, 4);
+    put32(block.data() + 4, ENTRIES_PER_BLOCK);
+    // Zeroed entries fail their CRC check, which reads as "unused"
+    if (!writeAt(fd, block.data(), BLOCK_SIZE, offset) || fsync(fd) != 0) {
+        setError("could not grow directory in " + path);
+        return false;
+    }
+
+    // Link it in only once its contents are durable
+    char link[8];
+    put64(link, offset);
+    uint64_t linkPosition = directoryBlocks.empty() ? 8 : directoryBlocks.back() + 8;
+    if (!writeAt(fd, link, sizeof(link), linkPosition) || fsync(fd) != 0) {
+        setError("could not grow directory in " + path);
+        return false;
+    }
+
+    uint32_t base = static_cast<uint32_t>(directoryBlocks.size()) * ENTRIES_PER_BLOCK;
+    directoryBlocks.push_back(offset);
+    for (uint32_t i = ENTRIES_PER_BLOCK; i > 0; i--) {
+        freeEntries.push_back(base + i - 1);
+    }
+    return true;
+}
+
+// Best fit from the free list (the smallest extent that is big enough,
+// lowest offset first), splitting off the remainder; otherwise extend the
+// file
+uint64_t SaveStore::allocate(uint64_t size) {
+    auto best = freeBySize.lower_bound(std::make_pair(size, static_cast<uint64_t>(0)));
+    if (best == freeBySize.end()) {
+        uint64_t offset = fileEnd;
+        fileEnd += size;
+        return offset;
+    }
+
+    uint64_t offset = best->second;
+    uint64_t remainder = best->first - size;
+    freeBySize.erase(best);
+    freeExtents.erase(offset);
+    if (remainder > 0) {
+        freeExtents[offset + size] = remainder;
+        freeBySize.insert(std::make_pair(remainder, offset + size));
+    }
+    return offset;
+}
+
+void SaveStore::release(uint64_t offset, uint64_t size) {
+    auto next = freeExtents.lower_bound(offset);
+    // Merge with the following extent
+    if (next != freeExtents.end() && offset + size == next->first) {
+        size += next->second;
+        freeBySize.erase(std::make_pair(next->second, next->first));
+        next = freeExtents.erase(next);
+    }
+    // Merge with the preceding extent
+    if (next != freeExtents.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            freeBySize.erase(std::make_pair(prev->second, prev->first));
+            prev->second += size;
+            freeBySize.insert(std::make_pair(prev->second, prev->first));
+            return;
+        }
+    }
+    freeExtents[offset] = size;
+    freeBySize.insert(std::make_pair(size, offset));
+}
+
+bool SaveStore::put(const std::string& profile, const std::string& record) {
+    if (fd < 0 || profile.empty() || profile.size() > MAX_PROFILE_NAME) {
+        return false;
+    }
+    std::lock_guard<std::mutex> writer(writerMutex);
+
+    // Only this thread modifies the index, so reading it here is safe
+    auto existing = index.find(profile);
+    bool replacing = existing != index.end();
+    Slot oldSlot = replacing ? existing->second : Slot();
+
+    Slot slot;
+    slot.length = static_cast<uint32_t>(record.size());
+    slot.capacity = static_cast<uint32_t>(roundUp(record.size()));
+    slot.recordCrc = SaveFormat::crc32(record.data(), record.size());
+    slot.generation = replacing ? oldSlot.generation + 1 : 1;
+    slot.offset = allocate(slot.capacity);
+
+    // New copy first; the old record stays intact until the entry flips
+    if (!writeAt(fd, record.data(), record.size(), slot.offset) || fsync(fd) != 0) {
+        release(slot.offset, slot.capacity);
+        setError("could not write record for " + profile);
+        return false;
+    }
+
+    if (replacing) {
+        slot.entryIndex = oldSlot.entryIndex;
+    } else {
+        if (freeEntries.empty() && !addDirectoryBlock()) {
+            release(slot.offset, slot.capacity);
+            return false;
+        }
+        slot.entryIndex = freeEntries.back();
+        freeEntries.pop_back();
+    }
+    if (!writeEntry(slot.entryIndex, profile, &slot)) {
+        release(slot.offset, slot.capacity);
+        if (!replacing) freeEntries.push_back(slot.entryIndex);
+        setError("could not update directory for " + profile);
+        return false;
+    }
+
+    pthread_rwlock_wrlock(&indexLock);
+    index[profile] = slot;
+    pthread_rwlock_unlock(&indexLock);
+
+    // Readers of the old copy held the read lock, so they are done with it
+    if (replacing) {
+        release(oldSlot.offset, oldSlot.capacity);
+    }
+    return true;
+}
+
+bool SaveStore::get(const std::string& profile, std::string& record) const {
+    if (fd < 0) {
+        return false;
+    }
+    pthread_rwlock_rdlock(&indexLock);
+    auto it = index.find(profile);
+    bool found = it != index.end();
+    bool ok = false;
+    if (found) {
+        record.resize(it->second.length);
+        ok = readAt(fd, &record[0], record.size(), it->second.offset) &&
+             SaveFormat::crc32(record.data(), record.size()) == it->second.recordCrc;
+    }
+    pthread_rwlock_unlock(&indexLock);
+    return ok;
+}
+
+bool SaveStore::remove(const std::string& profile) {
+    if (fd < 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> writer(writerMutex);
+    auto it = index.find(profile);
+    if (it == index.end()) {
+        return false;
+    }
+    Slot slot = it->second;
+    if (!writeEntry(slot.entryIndex, profile, nullptr)) {
+        setError("could not update directory for " + profile);
+        return false;
+    }
+
+    pthread_rwlock_wrlock(&indexLock);
+    index.erase(profile);
+    pthread_rwlock_unlock(&indexLock);
+
+    freeEntries.push_back(slot.entryIndex);
+    release(slot.offset, slot.capacity);
+    return true;
+}
+
+bool SaveStore::contains(const std::string& profile) const {
+    pthread_rwlock_rdlock(&indexLock);
+    bool found = index.count(profile) > 0;
+    pthread_rwlock_unlock(&indexLock);
+    return found;
+}
+
+std::vector<std::string> SaveStore::listProfiles() const {
+    std::vector<std::string> names;
+    pthread_rwlock_rdlock(&indexLock);
+    names.reserve(index.size());
+    for (const auto& pair : index) {
+        names.push_back(pair.first);
+    }
+    pthread_rwlock_unlock(&indexLock);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+size_t SaveStore::getProfileCount() const {
+    pthread_rwlock_rdlock(&indexLock);
+    size_t count = index.size();
+    pthread_rwlock_unlock(&indexLock);
+    return count;
+}
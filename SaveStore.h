@@ -0,0 +1,86 @@
+#ifndef SAVESTORE_H
+#define SAVESTORE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <pthread.h>
+
+// Many player profiles in one file.
+//
+// Layout: a small file header, a chain of directory blocks holding
+// fixed-size entries (profile name -> record extent), and record extents
+// allocated in 256-byte units. The whole directory is read once at open
+// into an in-memory hash index, so lookups never touch the disk.
+//
+// Writes are copy-on-write: a record is written to a free extent and
+// synced before its directory entry is switched over, so a crash leaves
+// either the old or the new record. Extents released by an update or a
+// removal are reused by later writes; space orphaned by a crash is found
+// again at open because free space is derived from the live entries.
+//
+// Any number of threads may call get() concurrently with one writer;
+// writers are serialized internally. The free list and directory live in
+// the opening process's memory, so only one process may have a store open:
+// the file is locked at open, and a second process gets a store that is
+// not open ("save store in use").
+class SaveStore {
+private:
+    struct Slot {
+        uint32_t entryIndex;
+        uint64_t offset;
+        uint32_t length;
+        uint32_t capacity;
+        uint32_t recordCrc;
+        uint32_t generation;
+    };
+
+    std::string path;
+    int fd;
+    std::string error;
+    mutable std::mutex errorMutex;             // put()/remove() set error while others read it
+
+    std::unordered_map<std::string, Slot> index;
+    std::vector<uint64_t> directoryBlocks;     // file offsets, in chain order
+    std::vector<uint32_t> freeEntries;         // unused directory entries
+    std::map<uint64_t, uint64_t> freeExtents;  // offset -> size, coalesced
+    std::set<std::pair<uint64_t, uint64_t>> freeBySize; // (size, offset), same extents
+    uint64_t fileEnd;
+
+    mutable pthread_rwlock_t indexLock;        // readers vs. index updates
+    std::mutex writerMutex;                    // one writer at a time
+
+    void setError(const std::string& message);
+    bool create();
+    bool load();
+    uint64_t entryPosition(uint32_t entryIndex) const;
+    bool writeEntry(uint32_t entryIndex, const std::string& profile, const Slot* slot);
+    bool addDirectoryBlock();
+    uint64_t allocate(uint64_t size);
+    void release(uint64_t offset, uint64_t size);
+
+public:
+    static const size_t MAX_PROFILE_NAME = 96;
+
+    explicit SaveStore(const std::string& filename);
+    ~SaveStore();
+    SaveStore(const SaveStore&) = delete;
+    SaveStore& operator=(const SaveStore&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+    // The last failure, copied so it stays valid while writers go on
+    std::string getError() const;
+
+    bool put(const std::string& profile, const std::string& record);
+    bool get(const std::string& profile, std::string& record) const;
+    bool remove(const std::string& profile);
+    bool contains(const std::string& profile) const;
+    std::vector<std::string> listProfiles() const;
+    size_t getProfileCount() const;
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "Scheduler.h"
+#include <iomanip>
+
+Scheduler::Scheduler(size_t threads) : queued(0), stopping(false) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+    }
+    for (size_t i = 0; i < threads; i++) {
+        workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+    // Start threads only once every queue exists, since they steal
+    for (size_t i = 0; i < threads; i++) {
+        workers[i]->thread = std::thread(&Scheduler::workerLoop, this, i);
+    }
+}
+
+Scheduler::~Scheduler() {
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        stopping = true;
+    }
+    wakeIdle.notify_all();
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+void Scheduler::submit(size_t index, Task task) {
+    Worker& worker = *workers[index % workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.queue.push_back(std::move(task));
+        if (worker.queue.size() > worker.maxDepth) {
+            worker.maxDepth = worker.queue.size();
+        }
+        queued++;
+    }
+    // Taking the lock orders this with a worker deciding to sleep
+    { std::lock_guard<std::mutex> lock(idleMutex); }
+    wakeIdle.notify_one();
+}
+
+bool Scheduler::popOwn(size_t index, Task& task) {
+    Worker& worker = *workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.queue.empty()) {
+        return false;
+    }
+    task = std::move(worker.queue.front());
+    worker.queue.pop_front();
+    queued--;
+    return true;
+}
+
+// Take the newest task of the first other worker that has any; the owner
+// keeps running its oldest ones
+bool Scheduler::steal(size_t thief, Task& task) {
+    for (size_t offset = 1; offset < workers.size(); offset++) {
+        Worker& victim = *workers[(thief + offset) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.queue.empty()) {
+            continue;
+        }
+        task = std::move(victim.queue.back());
+        victim.queue.pop_back();
+        queued--;
+        workers[thief]->stolen++;
+        return true;
+    }
+    return false;
+}
+
+void Scheduler::workerLoop(size_t index) {
+    Worker& self = *workers[index];
+    Task task;
+    while (true) {
+        if (popOwn(index, task) || steal(index, task)) {
+            task();
+            task = nullptr; // release what it captured before sleeping
+            self.ran++;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(idleMutex);
+        wakeIdle.wait(lock, [this] { return queued > 0 || stopping; });
+        if (stopping && queued == 0) {
+            return;
+        }
+    }
+}
+
+std::vector<Scheduler::WorkerStats> Scheduler::stats() {
+    std::vector<WorkerStats> result;
+    for (auto& worker : workers) {
+        WorkerStats entry;
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            entry.depth = worker->queue.size();
+            entry.maxDepth = worker->maxDepth;
+        }
+        entry.ran = worker->ran;
+        entry.stolen = worker->stolen;
+        result.push_back(entry);
+    }
+    return result;
+}
+
+void Scheduler::report(std::ostream& out) {
+    std::vector<WorkerStats> all = stats();
+    for (size_t i = 0; i < all.size(); i++) {
+        out << "worker " << std::setw(2) << i
+            << "  queued " << std::setw(4) << all[i].depth
+            << " (max " << all[i].maxDepth << ")"
+            << "  ran " << all[i].ran
+            << "  stole " << all[i].stolen << "\n";
+    }
+}
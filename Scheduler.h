@@ -0,0 +1,70 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <ostream>
+#include <cstdint>
+
+// A pool of worker threads, one run queue each. Work is submitted to a
+// particular worker (the server shards sessions by socket) and runs there
+// in FIFO order; a worker whose queue is empty steals from the back of
+// the others' queues before going to sleep. Tasks should be short slices:
+// anything with more to do submits itself again, which puts it behind the
+// work that was already waiting.
+class Scheduler {
+public:
+    typedef std::function<void()> Task;
+
+    struct WorkerStats {
+        size_t depth;       // tasks queued right now
+        size_t maxDepth;
+        uint64_t ran;       // tasks run, own and stolen
+        uint64_t stolen;    // tasks this worker took from another queue
+    };
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> queue;
+        size_t maxDepth;
+        std::atomic<uint64_t> ran;
+        std::atomic<uint64_t> stolen;
+        std::thread thread;
+
+        Worker() : maxDepth(0), ran(0), stolen(0) {}
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // Idle workers sleep here until something is queued anywhere
+    std::mutex idleMutex;
+    std::condition_variable wakeIdle;
+    std::atomic<size_t> queued;
+    bool stopping;
+
+    bool popOwn(size_t index, Task& task);
+    bool steal(size_t thief, Task& task);
+    void workerLoop(size_t index);
+
+public:
+    // threads == 0 uses one worker per core
+    explicit Scheduler(size_t threads = 0);
+    ~Scheduler(); // runs what is still queued, then joins the workers
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    size_t workerCount() const { return workers.size(); }
+    void submit(size_t worker, Task task);
+
+    std::vector<WorkerStats> stats();
+    void report(std::ostream& out);
+};
+
+#endif
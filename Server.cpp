@@ -0,0 +1,1019 @@
+#include "Server.h"
+#include "Game.h"
+#include "Console.h"
+#include "CommandSource.h"
+#include "Colors.h"
+#include "Scheduler.h"
+#include "Latency.h"
+#include "Trace.h"
+#include "Terminal.h"
+#include "Animation.h"
+#include <iostream>
+#include <algorithm>
+#include <streambuf>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static const size_t MAX_LINE = 4096;           // longest input line accepted
+static const size_t MAX_QUEUED_LINES = 1024;   // typed ahead of the game
+static const size_t MAX_OUTBOX = 256 * 1024;   // unsent output before the game waits
+static const int SLICE_LINES = 4;              // lines answered before yielding the worker
+static const size_t MAX_SPECTATOR_FRAMES = 32; // queued for a watcher before it skips ahead
+
+static volatile sig_atomic_t stopRequested = 0;
+static volatile sig_atomic_t reportRequested = 0;
+static volatile sig_atomic_t traceRequested = 0;
+static int signalWakeFd = -1;
+
+static void onSignal(int signal) {
+    if (signal == SIGUSR1) {
+        reportRequested = 1;
+    } else if (signal == SIGUSR2) {
+        traceRequested = 1;
+    } else {
+        stopRequested = 1;
+    }
+    if (signalWakeFd >= 0) {
+        ssize_t ignored = write(signalWakeFd, "s", 1);
+        (void)ignored;
+    }
+}
+
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 &&
+           fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+}
+
+// A chunk of output as sent to a socket. A player's output becomes one
+// frame per batch and the same buffer is queued for the player and every
+// spectator, so watching costs a reference, not a copy or a re-render.
+typedef std::shared_ptr<const std::string> Frame;
+
+static Frame makeFrame(std::string text) {
+    return std::make_shared<const std::string>(std::move(text));
+}
+
+// Socket side of a client; loop thread only
+class Connection {
+public:
+    const int fd;
+    std::string inbox;          // partial input line
+    std::deque<Frame> frames;   // output waiting for the socket
+    size_t frameOffset;         // bytes of frames.front() already sent
+    bool readsOpen;             // false once the client has sent EOF
+    bool peerGone;              // connection lost: nothing more can be sent
+    bool watchingWrites;
+
+    explicit Connection(int socket)
+        : fd(socket), frameOffset(0), readsOpen(true), peerGone(false), watchingWrites(false) {}
+    virtual ~Connection() {}
+};
+
+// Someone watching a live session. Frames are queued like anyone else's,
+// but a watcher that falls MAX_SPECTATOR_FRAMES behind skips straight to
+// the newest frame instead of buffering without bound.
+class Spectator : public Connection {
+public:
+    int watching;           // session number, 0 in the lobby
+    uint64_t skippedFrames;
+
+    explicit Spectator(int socket) : Connection(socket), watching(0), skippedFrames(0) {}
+
+    void queue(const Frame& frame) {
+        if (frames.size() >= MAX_SPECTATOR_FRAMES) {
+            // Keep only a frame that is partly sent; cutting it would garble the terminal
+            size_t keep = frameOffset > 0 ? 1 : 0;
+            skippedFrames += frames.size() - keep;
+            frames.erase(frames.begin() + keep, frames.end());
+            static const Frame notice = makeFrame("\n[... fell behind, skipping ahead ...]\n");
+            frames.push_back(notice);
+        }
+        frames.push_back(frame);
+    }
+};
+
+// One player and its Game. The loop thread owns the socket and queues
+// complete lines here; a scheduler worker runs the game a slice at a time
+// and leaves its output in the outbox. `scheduled` is set while the
+// session is queued or running, so only one worker touches the game.
+// With animations on, the output is timed frames: the loop plays them on
+// its own clock and shows the rest at once when the client sends a line.
+class Session : public Connection {
+private:
+    std::mutex mutex;
+    std::deque<std::string> lines;   // received, not yet answered
+    std::deque<Animation::Frame> outbox; // printed, not yet taken by the loop
+    size_t outboxBytes;
+    bool inputClosed;
+    bool outputClosed;
+    bool started;
+    bool scheduled;
+    bool finished;
+
+    // Worker side
+    const bool animated;
+    Animation::Recorder recorder;    // collects whatever the game prints
+    Terminal::FilterBuffer terminal; // suits the output to the client's terminal
+    std::ostream stream;
+    QueueSource input;   // stays empty; the game is driven through feed()
+    std::unique_ptr<Game> game;
+    bool answering;           // the game has had a line; TERM= is input from now on
+    std::string playerName;   // copied out after each slice for the lobby
+    std::string region;
+
+    // Caller holds the mutex
+    bool hasWork() const {
+        if (finished) return false;
+        if (!started) return true;
+        return (!lines.empty() || inputClosed) && outboxBytes < MAX_OUTBOX;
+    }
+
+    // Next thing for the game to answer: a line, or end of input
+    bool nextInput(std::string& line, bool& endOfInput) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (outboxBytes + recorder.size() >= MAX_OUTBOX) {
+            return false; // wait for the client to catch up
+        }
+        endOfInput = lines.empty();
+        if (endOfInput) {
+            return inputClosed;
+        }
+        line.swap(lines.front());
+        lines.pop_front();
+        return true;
+    }
+
+public:
+    const int number;          // shown to spectators
+    // Loop thread only
+    std::vector<int> watchers; // spectator sockets
+    Frame lastFrame;           // shown first to a new watcher
+    std::deque<Animation::Frame> playing; // taken from the outbox, not yet sent
+    std::chrono::steady_clock::time_point holdUntil; // when the next one is due
+
+    Session(int socket, int sessionNumber, Terminal::Tier tier, bool animations)
+        : Connection(socket), outboxBytes(0), inputClosed(false), outputClosed(false), started(false),
+          scheduled(false), finished(false), animated(animations), terminal(&recorder, tier),
+          stream(&terminal), answering(false), number(sessionNumber) {
+    }
+
+    bool pushLine(const std::string& line) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (lines.size() >= MAX_QUEUED_LINES) {
+            return false;
+        }
+        lines.push_back(line);
+        return true;
+    }
+
+    // End of input: the game sees EOF once it has answered the queued
+    // lines, and its remaining output is still delivered
+    void closeInput() {
+        std::lock_guard<std::mutex> lock(mutex);
+        inputClosed = true;
+    }
+
+    // Connection lost: end input and drop any further output
+    void disconnect() {
+        peerGone = true;
+        frames.clear();
+        frameOffset = 0;
+        std::lock_guard<std::mutex> lock(mutex);
+        inputClosed = true;
+        outputClosed = true;
+        outbox.clear();
+        outboxBytes = 0;
+        playing.clear();
+    }
+
+    // True when the caller should queue a slice for this session
+    bool claimRun() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (scheduled || !hasWork()) {
+            return false;
+        }
+        scheduled = true;
+        return true;
+    }
+
+    // A line naming the client's terminal switches the session's tier:
+    // "TERM=xterm-256color COLORTERM=truecolor", "TERM=dumb", "TERM=plain".
+    // Only before the game's first answer, so a name or shop answer that
+    // happens to start with TERM= still reaches the game.
+    bool negotiate(const std::string& line) {
+        if (answering || line.compare(0, 5, "TERM=") != 0) {
+            return false;
+        }
+        std::string term = line.substr(5);
+        std::string colorTerm;
+        size_t space = term.find(' ');
+        if (space != std::string::npos) {
+            std::string rest = term.substr(space + 1);
+            term.erase(space);
+            if (rest.compare(0, 10, "COLORTERM=") == 0) {
+                colorTerm = rest.substr(10);
+            }
+        }
+        Terminal::Tier tier;
+        if (!Terminal::parseTier(term, tier)) {
+            tier = Terminal::fromTerm(term, colorTerm);
+        }
+        terminal.setTier(tier);
+        stream << "[terminal: " << Terminal::tierName(tier) << "]\n";
+        return true;
+    }
+
+    // Answer up to SLICE_LINES lines on a worker; true when there is more
+    // to do and the caller should queue another slice
+    bool runSlice() {
+        Colors::setAnimationsEnabled(animated);
+        Animation::record(animated ? &recorder : nullptr);
+        Console::redirect(&stream);
+        if (!game) {
+            game.reset(new Game(input));
+            // Lines typed ahead, or output the client has yet to take, make
+            // the map and menu of the turns in between not worth sending
+            game->setPacer(FramePacer([this] {
+                std::lock_guard<std::mutex> lock(mutex);
+                return !lines.empty();
+            }, [this] {
+                std::lock_guard<std::mutex> lock(mutex);
+                return outboxBytes > 0;
+            }));
+            game->start();
+        } else {
+            std::string line;
+            bool endOfInput;
+            for (int i = 0; i < SLICE_LINES && !game->isFinished() && nextInput(line, endOfInput); i++) {
+                recorder.coalesce(); // the last answer's animation is already out of date
+                if (endOfInput) {
+                    game->endOfInput();
+                } else if (!negotiate(line)) {
+                    answering = true;
+                    game->feed(line);
+                }
+            }
+        }
+        Console::redirect(nullptr);
+        Animation::record(nullptr);
+
+        bool done = game->isFinished();
+        std::string name = game->getPlayerName();
+        std::string where = game->getCurrentRegion();
+        if (done) {
+            game.reset(); // saves and frees the world here rather than on the loop
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        playerName.swap(name);
+        region.swap(where);
+        if (!lines.empty()) {
+            recorder.coalesce();
+        }
+        if (!outputClosed) {
+            outboxBytes += recorder.size();
+            recorder.take(outbox);
+        } else {
+            std::deque<Animation::Frame> dropped;
+            recorder.take(dropped);
+        }
+        started = true;
+        finished = done;
+        scheduled = hasWork();
+        return scheduled;
+    }
+
+    // Appends to `into`
+    void takeOutput(std::deque<Animation::Frame>& into) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Animation::Frame& frame : outbox) {
+            into.push_back(Animation::Frame(std::string(), frame.holdMs));
+            into.back().text.swap(frame.text);
+        }
+        outbox.clear();
+        outboxBytes = 0;
+    }
+
+    bool hasQueuedInput() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !lines.empty();
+    }
+
+    bool isFinished() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return finished;
+    }
+
+    std::string describe() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (playerName.empty()) {
+            return "(creating a character)";
+        }
+        return playerName + " - " + region;
+    }
+};
+
+// Readiness notification: epoll on Linux, poll() elsewhere
+class Server::Poller {
+public:
+    struct Event {
+        int fd;
+        bool readable;
+        bool writable;
+        bool hangup;   // reported even when not watching reads
+    };
+
+#ifdef __linux__
+private:
+    int epollFd;
+
+    bool control(int op, int fd, bool readable, bool writable) {
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = 0;
+        if (readable) {
+            event.events |= EPOLLIN | EPOLLRDHUP;
+        }
+        if (writable) {
+            event.events |= EPOLLOUT;
+        }
+        event.data.fd = fd;
+        return epoll_ctl(epollFd, op, fd, &event) == 0;
+    }
+
+public:
+    Poller() : epollFd(epoll_create1(EPOLL_CLOEXEC)) {}
+    ~Poller() { if (epollFd >= 0) ::close(epollFd); }
+
+    bool add(int fd) { return control(EPOLL_CTL_ADD, fd, true, false); }
+    void watch(int fd, bool readable, bool writable) { control(EPOLL_CTL_MOD, fd, readable, writable); }
+    void remove(int fd) { epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr); }
+
+    void wait(std::vector<Event>& ready, int timeoutMs) {
+        epoll_event events[256];
+        ready.clear();
+        int count = epoll_wait(epollFd, events, 256, timeoutMs);
+        for (int i = 0; i < count; i++) {
+            uint32_t flags = events[i].events;
+            Event event;
+            event.fd = events[i].data.fd;
+            event.readable = (flags & (EPOLLIN | EPOLLRDHUP)) != 0;
+            event.writable = (flags & EPOLLOUT) != 0;
+            event.hangup = (flags & (EPOLLHUP | EPOLLERR)) != 0;
+            ready.push_back(event);
+        }
+    }
+#else
+private:
+    std::vector<pollfd> fds;
+    std::map<int, size_t> slots;
+
+public:
+    bool add(int fd) {
+        pollfd entry;
+        entry.fd = fd;
+        entry.events = POLLIN;
+        entry.revents = 0;
+        slots[fd] = fds.size();
+        fds.push_back(entry);
+        return true;
+    }
+
+    void watch(int fd, bool readable, bool writable) {
+        auto it = slots.find(fd);
+        if (it != slots.end()) {
+            fds[it->second].events = static_cast<short>((readable ? POLLIN : 0) | (writable ? POLLOUT : 0));
+        }
+    }
+
+    void remove(int fd) {
+        auto it = slots.find(fd);
+        if (it == slots.end()) {
+            return;
+        }
+        // Move the last entry into the hole
+        size_t slot = it->second;
+        slots.erase(it);
+        if (slot != fds.size() - 1) {
+            fds[slot] = fds.back();
+            slots[fds[slot].fd] = slot;
+        }
+        fds.pop_back();
+    }
+
+    void wait(std::vector<Event>& ready, int timeoutMs) {
+        ready.clear();
+        if (poll(fds.data(), fds.size(), timeoutMs) <= 0) {
+            return;
+        }
+        for (const pollfd& entry : fds) {
+            if (entry.revents == 0) continue;
+            Event event;
+            event.fd = entry.fd;
+            event.readable = (entry.revents & POLLIN) != 0;
+            event.writable = (entry.revents & POLLOUT) != 0;
+            event.hangup = (entry.revents & (POLLHUP | POLLERR)) != 0;
+            ready.push_back(event);
+        }
+    }
+#endif
+};
+
+Server::Server(size_t workers)
+    : poller(new Poller()), scheduler(new Scheduler(workers)), sessionCount(0), skippedByClosed(0), statsInterval(0), defaultTier(Terminal::Tier::RICH), animations(false), wakeRead(-1), wakeWrite(-1) {
+    int fds[2];
+    if (pipe(fds) == 0) {
+        wakeRead = fds[0];
+        wakeWrite = fds[1];
+        setNonBlocking(wakeRead);
+        setNonBlocking(wakeWrite);
+        poller->add(wakeRead);
+    } else {
+        error = "could not create wake pipe";
+    }
+}
+
+Server::~Server() {
+    scheduler.reset(); // finishes any slices still queued
+    sessions.clear();
+    for (auto& pair : spectators) {
+        ::close(pair.first);
+    }
+    for (int fd : listeners) {
+        ::close(fd);
+    }
+    for (int fd : spectatorListeners) {
+        ::close(fd);
+    }
+    for (const std::string& path : unixPaths) {
+        unlink(path.c_str());
+    }
+    if (wakeRead >= 0) ::close(wakeRead);
+    if (wakeWrite >= 0) ::close(wakeWrite);
+}
+
+bool Server::addListener(int fd, bool forSpectators) {
+    if (listen(fd, SOMAXCONN) != 0 || !setNonBlocking(fd) || !poller->add(fd)) {
+        error = std::string("listen failed: ") + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    (forSpectators ? spectatorListeners : listeners).push_back(fd);
+    return true;
+}
+
+bool Server::listenUnix(const std::string& path, bool forSpectators) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    if (path.size() >= sizeof(address.sun_path)) {
+        error = "socket path too long: " + path;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        error = std::string("socket failed: ") + std::strerror(errno);
+        return false;
+    }
+    unlink(path.c_str()); // stale socket from an earlier run
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        error = "could not bind " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    unixPaths.push_back(path);
+    return addListener(fd, forSpectators);
+}
+
+bool Server::listenTcp(int port, bool forSpectators) {
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        error = std::string("socket failed: ") + std::strerror(errno);
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        error = "could not bind 127.0.0.1:" + std::to_string(port) + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    return addListener(fd, forSpectators);
+}
+
+void Server::acceptClients(int listener, bool forSpectators) {
+    while (true) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            return; // EAGAIN: accepted everything pending
+        }
+        if (!setNonBlocking(fd) || !poller->add(fd)) {
+            ::close(fd);
+            continue;
+        }
+        if (forSpectators) {
+            std::shared_ptr<Spectator> spectator = std::make_shared<Spectator>(fd);
+            spectators[fd] = spectator;
+            showLobby(*spectator);
+            continue;
+        }
+        std::shared_ptr<Session> session = std::make_shared<Session>(fd, ++sessionCount, defaultTier, animations);
+        sessions[fd] = session;
+        schedule(session);
+    }
+}
+
+// Read whatever has arrived and split off complete lines. OPEN while the
+// client may send more; FAILED on a reset or an over-long line.
+Server::ReadResult Server::readLines(Connection& client, std::vector<std::string>& lines) {
+    char chunk[4096];
+    while (true) {
+        ssize_t got = read(client.fd, chunk, sizeof(chunk));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return ReadResult::OPEN;
+        }
+        if (got == 0) {
+            return ReadResult::ENDED;
+        }
+        if (got < 0) {
+            return ReadResult::FAILED; // connection reset
+        }
+
+        client.inbox.append(chunk, static_cast<size_t>(got));
+        size_t start = 0;
+        size_t newline;
+        while ((newline = client.inbox.find('\n', start)) != std::string::npos) {
+            lines.push_back(client.inbox.substr(start, newline - start));
+            start = newline + 1;
+        }
+        client.inbox.erase(0, start);
+        if (client.inbox.size() > MAX_LINE || lines.size() > MAX_QUEUED_LINES) {
+            return ReadResult::FAILED;
+        }
+    }
+}
+
+void Server::readFrom(Session& session) {
+    std::vector<std::string> lines;
+    ReadResult result = readLines(session, lines);
+    bool flooded = false;
+    for (const std::string& line : lines) {
+        if (!session.pushLine(line)) {
+            flooded = true;
+            break;
+        }
+    }
+    if (!lines.empty() && !session.playing.empty()) {
+        // Answering: the animation on screen skips to its end
+        Animation::coalesce(session.playing);
+        session.holdUntil = std::chrono::steady_clock::time_point();
+    }
+    if (result == ReadResult::ENDED && !flooded) {
+        // Client is done sending; keep the socket for the replies
+        session.readsOpen = false;
+        poller->watch(session.fd, false, session.watchingWrites);
+        session.closeInput();
+    } else if (result == ReadResult::FAILED || flooded) {
+        // Flooded or reset: stop watching the socket and let the game wind down
+        poller->remove(session.fd);
+        session.disconnect();
+    }
+}
+
+void Server::writeTo(Connection& client) {
+    while (!client.peerGone && !client.frames.empty()) {
+        const std::string& frame = *client.frames.front();
+        ssize_t sent = send(client.fd, frame.data() + client.frameOffset, frame.size() - client.frameOffset,
+                            MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // Socket full: finish when it drains
+                if (!client.watchingWrites) {
+                    poller->watch(client.fd, client.readsOpen, true);
+                    client.watchingWrites = true;
+                }
+                return;
+            }
+            poller->remove(client.fd);
+            client.peerGone = true;
+            client.frames.clear();
+            client.frameOffset = 0;
+            return;
+        }
+        client.frameOffset += static_cast<size_t>(sent);
+        if (client.frameOffset == frame.size()) {
+            client.frames.pop_front();
+            client.frameOffset = 0;
+        }
+    }
+    if (client.watchingWrites && !client.peerGone) {
+        poller->watch(client.fd, client.readsOpen, false);
+        client.watchingWrites = false;
+    }
+}
+
+// Once the player's socket has taken everything queued, send the game's
+// new output up to the next animation hold as one frame for the player
+// and everyone watching; the rest waits in session.playing until
+// playAnimations() finds it due
+void Server::collectOutput(Session& session) {
+    if (session.peerGone || !session.frames.empty()) {
+        return;
+    }
+    session.takeOutput(session.playing);
+    if (session.playing.empty()) {
+        return;
+    }
+    if (session.hasQueuedInput()) {
+        Animation::coalesce(session.playing);
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now < session.holdUntil) {
+        animating.insert(session.fd);
+        return;
+    }
+    std::string text;
+    while (!session.playing.empty()) {
+        Animation::Frame& next = session.playing.front();
+        text += next.text;
+        int holdMs = next.holdMs;
+        session.playing.pop_front();
+        if (holdMs > 0) {
+            session.holdUntil = now + std::chrono::milliseconds(holdMs);
+            break;
+        }
+    }
+    if (!session.playing.empty()) {
+        animating.insert(session.fd);
+    }
+    if (text.empty()) {
+        return;
+    }
+    Frame frame = makeFrame(std::move(text));
+    session.frames.push_back(frame);
+    session.lastFrame = frame;
+    for (int fd : session.watchers) {
+        auto it = spectators.find(fd);
+        if (it != spectators.end()) {
+            it->second->queue(frame);
+            writeTo(*it->second);
+        }
+    }
+}
+
+// Sessions whose socket is still busy are left to the writable event
+int Server::playAnimations() {
+    std::vector<std::shared_ptr<Session>> due;
+    auto now = std::chrono::steady_clock::now();
+    for (int fd : animating) {
+        auto it = sessions.find(fd);
+        if (it != sessions.end() && it->second->frames.empty() && it->second->holdUntil <= now) {
+            due.push_back(it->second);
+        }
+    }
+    for (const std::shared_ptr<Session>& session : due) {
+        service(session);
+    }
+
+    auto next = std::chrono::steady_clock::time_point::max();
+    for (auto fd = animating.begin(); fd != animating.end();) {
+        auto it = sessions.find(*fd);
+        if (it == sessions.end() || it->second->playing.empty()) {
+            fd = animating.erase(fd);
+            continue;
+        }
+        if (it->second->frames.empty()) {
+            next = std::min(next, it->second->holdUntil);
+        }
+        ++fd;
+    }
+    if (next == std::chrono::steady_clock::time_point::max()) {
+        return -1;
+    }
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - now).count();
+    return wait > 0 ? static_cast<int>(wait) + 1 : 1;
+}
+
+void Server::notifyReady(int fd) {
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(readyMutex);
+        wasEmpty = readyFds.empty();
+        readyFds.push_back(fd);
+    }
+    // One wake byte per batch is enough
+    if (wasEmpty) {
+        ssize_t ignored = write(wakeWrite, "w", 1);
+        (void)ignored;
+    }
+}
+
+// Queue a slice on the session's home worker if it has anything to do
+void Server::schedule(const std::shared_ptr<Session>& session) {
+    if (session->claimRun()) {
+        scheduler->submit(static_cast<size_t>(session->fd), [this, session] { runSlice(session); });
+    }
+}
+
+// On a worker. A session with more to do goes to the back of the queue, so
+// a long dungeon chain takes turns with everything else on that worker.
+void Server::runSlice(const std::shared_ptr<Session>& session) {
+    bool more = session->runSlice();
+    notifyReady(session->fd);
+    if (more) {
+        scheduler->submit(static_cast<size_t>(session->fd), [this, session] { runSlice(session); });
+    }
+}
+
+// Worker output is waiting: send it, then take more input if the outbox
+// had been full
+void Server::serviceReadySessions() {
+    std::vector<int> ready;
+    {
+        std::lock_guard<std::mutex> lock(readyMutex);
+        ready.swap(readyFds);
+    }
+    for (int fd : ready) {
+        auto it = sessions.find(fd);
+        if (it != sessions.end()) {
+            service(it->second);
+        }
+    }
+}
+
+void Server::service(const std::shared_ptr<Session>& session) {
+    {
+        Latency::Scope timer(Latency::Phase::FLUSH);
+        Trace::Span span("Server::flush");
+        collectOutput(*session);
+        writeTo(*session);
+        collectOutput(*session);
+        writeTo(*session);
+    }
+    if (session->isFinished()) {
+        if (session->peerGone || (session->frames.empty() && session->playing.empty()) || stopRequested) {
+            closeSession(session->fd);
+        }
+        return;
+    }
+    schedule(session);
+}
+
+void Server::closeSession(int fd) {
+    auto it = sessions.find(fd);
+    if (it == sessions.end()) {
+        return;
+    }
+    if (!it->second->peerGone) {
+        poller->remove(fd);
+    }
+    // Send its watchers back to the lobby
+    for (int watcher : it->second->watchers) {
+        auto spectator = spectators.find(watcher);
+        if (spectator != spectators.end()) {
+            spectator->second->watching = 0;
+            spectator->second->queue(makeFrame("\n[The game you were watching has ended.]\n"));
+            showLobby(*spectator->second);
+        }
+    }
+    sessions.erase(it);
+    ::close(fd);
+}
+
+// The list of live games and a prompt to pick one
+void Server::showLobby(Spectator& spectator) {
+    std::string text = "\n=== Live games ===\n";
+    if (sessions.empty()) {
+        text += "  (none right now)\n";
+    }
+    for (auto& pair : sessions) {
+        Session& session = *pair.second;
+        text += "  " + std::to_string(session.number) + ". " + session.describe() + "\n";
+    }
+    text += "Watch which game? (number, or Enter to refresh): ";
+    spectator.queue(makeFrame(std::move(text)));
+    writeTo(spectator);
+}
+
+// In the lobby a line picks a game; while watching, any line stops
+void Server::onSpectatorLine(Spectator& spectator, const std::string& line) {
+    if (spectator.watching != 0) {
+        stopWatching(spectator);
+        showLobby(spectator);
+        return;
+    }
+    int number = CommandSource::parseNumber(line, 0);
+    for (auto& pair : sessions) {
+        Session& session = *pair.second;
+        if (session.number != number || session.isFinished()) {
+            continue;
+        }
+        spectator.watching = number;
+        session.watchers.push_back(spectator.fd);
+        spectator.queue(makeFrame("\n[Watching game " + std::to_string(number) +
+                                  ". Press Enter to stop.]\n"));
+        if (session.lastFrame) {
+            spectator.queue(session.lastFrame);
+        }
+        writeTo(spectator);
+        return;
+    }
+    showLobby(spectator);
+}
+
+void Server::stopWatching(Spectator& spectator) {
+    for (auto& pair : sessions) {
+        Session& session = *pair.second;
+        if (session.number == spectator.watching) {
+            auto& list = session.watchers;
+            list.erase(std::remove(list.begin(), list.end(), spectator.fd), list.end());
+        }
+    }
+    spectator.watching = 0;
+}
+
+void Server::serviceSpectator(const std::shared_ptr<Spectator>& spectator, bool readable, bool hangup) {
+    if ((readable || hangup) && spectator->readsOpen && !spectator->peerGone) {
+        std::vector<std::string> lines;
+        ReadResult result = readLines(*spectator, lines);
+        for (const std::string& line : lines) {
+            onSpectatorLine(*spectator, line);
+        }
+        if (result != ReadResult::OPEN) {
+            closeSpectator(spectator->fd);
+            return;
+        }
+    } else if (hangup) {
+        closeSpectator(spectator->fd);
+        return;
+    }
+    writeTo(*spectator);
+    if (spectator->peerGone) {
+        closeSpectator(spectator->fd);
+    }
+}
+
+void Server::closeSpectator(int fd) {
+    auto it = spectators.find(fd);
+    if (it == spectators.end()) {
+        return;
+    }
+    stopWatching(*it->second);
+    skippedByClosed += it->second->skippedFrames;
+    if (!it->second->peerGone) {
+        poller->remove(fd);
+    }
+    spectators.erase(it);
+    ::close(fd);
+}
+
+void Server::report() {
+    uint64_t skipped = skippedByClosed;
+    for (auto& pair : spectators) {
+        skipped += pair.second->skippedFrames;
+    }
+    std::cerr << sessions.size() << " session(s), " << spectators.size()
+              << " spectator(s), " << skipped << " frame(s) skipped by slow spectators\n";
+    scheduler->report(std::cerr);
+    Latency::report(std::cerr);
+}
+
+void Server::setStatsInterval(int seconds) {
+    statsInterval = seconds;
+    nextStatsDump = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+}
+
+void Server::run() {
+    signalWakeFd = wakeWrite;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGUSR1, onSignal);
+    std::signal(SIGUSR2, onSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::cerr << "Server ready with " << scheduler->workerCount() << " worker(s)\n";
+    bool stopping = false;
+    std::vector<Poller::Event> events;
+    while (!stopping || !sessions.empty()) {
+        if (stopRequested && !stopping) {
+            stopping = true;
+            std::cerr << "Shutting down " << sessions.size() << " session(s)\n";
+            for (int fd : listeners) {
+                poller->remove(fd);
+            }
+            for (int fd : spectatorListeners) {
+                poller->remove(fd);
+            }
+            while (!spectators.empty()) {
+                closeSpectator(spectators.begin()->first);
+            }
+            std::vector<std::shared_ptr<Session>> open;
+            for (auto& pair : sessions) {
+                open.push_back(pair.second);
+            }
+            for (auto& session : open) {
+                session->closeInput();
+                schedule(session);
+            }
+        }
+        if (reportRequested) {
+            reportRequested = 0;
+            report();
+        }
+        if (traceRequested) {
+            traceRequested = 0;
+            if (traceFile.empty()) {
+                std::cerr << "Tracing is off (start the server with --trace FILE)\n";
+            } else {
+                long spans = Trace::writeJson(traceFile);
+                if (spans >= 0) {
+                    std::cerr << "Wrote " << spans << " trace spans to " << traceFile << "\n";
+                }
+            }
+        }
+
+        int timeoutMs = -1;
+        if (statsInterval > 0) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= nextStatsDump) {
+                report();
+                nextStatsDump = now + std::chrono::seconds(statsInterval);
+            }
+            timeoutMs = static_cast<int>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(nextStatsDump - now).count()) + 1;
+        }
+        int frameMs = playAnimations();
+        if (frameMs >= 0 && (timeoutMs < 0 || frameMs < timeoutMs)) {
+            timeoutMs = frameMs;
+        }
+        poller->wait(events, timeoutMs);
+        for (const Poller::Event& event : events) {
+            if (event.fd == wakeRead) {
+                char drain[256];
+                while (read(wakeRead, drain, sizeof(drain)) > 0) {}
+                continue;
+            }
+            bool forSpectators = std::find(spectatorListeners.begin(), spectatorListeners.end(), event.fd) !=
+                                 spectatorListeners.end();
+            if (forSpectators || std::find(listeners.begin(), listeners.end(), event.fd) != listeners.end()) {
+                if (!stopping) {
+                    acceptClients(event.fd, forSpectators);
+                }
+                continue;
+            }
+            auto watcher = spectators.find(event.fd);
+            if (watcher != spectators.end()) {
+                serviceSpectator(watcher->second, event.readable, event.hangup);
+                continue;
+            }
+            auto it = sessions.find(event.fd);
+            if (it == sessions.end()) {
+                continue;
+            }
+            std::shared_ptr<Session> session = it->second;
+            if ((event.readable || event.hangup) && session->readsOpen && !session->peerGone) {
+                readFrom(*session);
+            } else if (event.hangup && !session->peerGone) {
+                poller->remove(session->fd);
+                session->disconnect();
+            }
+            service(session);
+        }
+        serviceReadySessions();
+    }
+    scheduler->report(std::cerr);
+    Latency::report(std::cerr);
+    signalWakeFd = -1;
+}
@@ -0,0 +1,109 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <chrono>
+#include "Terminal.h"
+
+class Connection;
+class Session;
+class Spectator;
+class Scheduler;
+
+// Hosts many games in one process. Clients connect over a Unix-domain
+// socket or localhost TCP (e.g. with `nc` or `telnet`) and each connection
+// gets its own Game. One thread multiplexes every socket with non-blocking
+// I/O on epoll (poll() where epoll is unavailable); it splits input into
+// lines and writes output back as sockets accept it. The games themselves
+// run on a Scheduler: each session is sharded to a worker by socket and
+// answers a few lines per slice; idle workers steal from busy ones.
+// Spectators connect to their own listeners, pick a live game from a
+// lobby, and receive the same output frames as the player: each batch of
+// output is built once and shared by reference. A spectator whose socket
+// cannot keep up skips queued frames rather than holding memory.
+// A client may send "TERM=<name> [COLORTERM=<value>]" (or a tier name,
+// TERM=plain) as a line of its own to have its output suited to its
+// terminal from then on.
+// SIGUSR1 prints per-worker queue depth and steal counts along with the
+// latency percentiles of each game phase.
+class Server {
+private:
+    class Poller;
+
+    std::unique_ptr<Poller> poller;
+    std::unique_ptr<Scheduler> scheduler;
+    std::vector<int> listeners;
+    std::vector<int> spectatorListeners;
+    std::map<int, std::shared_ptr<Session>> sessions;     // by socket
+    std::map<int, std::shared_ptr<Spectator>> spectators; // by socket
+    int sessionCount;  // numbers the sessions for spectators
+    uint64_t skippedByClosed; // frames skipped by spectators who have left
+    int statsInterval;        // seconds between stats dumps, 0 for none
+    std::chrono::steady_clock::time_point nextStatsDump;
+    std::string traceFile;
+    Terminal::Tier defaultTier;
+    bool animations;          // sessions get timed animation frames
+    std::set<int> animating;  // sessions holding a frame back
+    std::vector<std::string> unixPaths;
+    std::string error;
+
+    // Signal handlers and workers with output write here to wake the loop
+    int wakeRead;
+    int wakeWrite;
+    std::mutex readyMutex;
+    std::vector<int> readyFds;
+
+    enum class ReadResult { OPEN, ENDED, FAILED };
+
+    bool addListener(int fd, bool forSpectators);
+    void acceptClients(int listener, bool forSpectators);
+    ReadResult readLines(Connection& client, std::vector<std::string>& lines);
+    void readFrom(Session& session);
+    void writeTo(Connection& client);
+    void collectOutput(Session& session);
+    int playAnimations(); // ms until the next frame is due, -1 for none
+    void notifyReady(int fd);
+    void schedule(const std::shared_ptr<Session>& session);
+    void runSlice(const std::shared_ptr<Session>& session);
+    void serviceReadySessions();
+    void service(const std::shared_ptr<Session>& session);
+    void closeSession(int fd);
+    void report();
+
+    void showLobby(Spectator& spectator);
+    void onSpectatorLine(Spectator& spectator, const std::string& line);
+    void stopWatching(Spectator& spectator);
+    void serviceSpectator(const std::shared_ptr<Spectator>& spectator, bool readable, bool hangup);
+    void closeSpectator(int fd);
+
+public:
+    explicit Server(size_t workers = 0); // 0: one worker per core
+    ~Server();
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    // Players connect by default; spectators on listeners opened with forSpectators
+    bool listenUnix(const std::string& path, bool forSpectators = false);
+    bool listenTcp(int port, bool forSpectators = false); // bound to 127.0.0.1 only
+    const std::string& getError() const { return error; }
+    // Also print the stats every so many seconds
+    void setStatsInterval(int seconds);
+    // SIGUSR2 writes the trace spans recorded so far to this file
+    void setTraceFile(const std::string& path) { traceFile = path; }
+    // What new sessions are sent until their client reports its terminal
+    void setDefaultTier(Terminal::Tier tier) { defaultTier = tier; }
+    // Play the games' animations to their clients; a line from the client
+    // skips the rest of the one playing
+    void setAnimations(bool on) { animations = on; }
+
+    // Serve until SIGINT/SIGTERM, then end every session (which autosaves)
+    void run();
+};
+
+#endif
@@ -1,8 +1,10 @@
 #include "Shop.h"
 #include "Colors.h"
+#include "Console.h"
+#include "Trace.h"
+#include "Ui.h"
 #include <iostream>
 #include <algorithm>
-#include <iomanip>
 
 Shop::Shop(const std::string& name) : shopName(name) {
     initializeItems();
@@ -17,89 +19,70 @@ void Shop::initializeItems() {
     items.push_back(Item("Greater Health Potion", "potion", 60, 40));
     items.push_back(Item("Greater Mana Potion", "potion", 50, 35));
     
-    // Weapons (for future expansion)
+    // Weapons (equipped from the inventory, add to ATK)
     items.push_back(Item("Iron Sword", "weapon", 5, 100));
     items.push_back(Item("Steel Sword", "weapon", 8, 200));
     items.push_back(Item("Magic Staff", "weapon", 6, 150));
     items.push_back(Item("Elven Bow", "weapon", 7, 180));
     
-    // Armor (for future expansion)
+    // Armor (equipped from the inventory, add to DEF)
     items.push_back(Item("Leather Armor", "armor", 3, 80));
     items.push_back(Item("Chain Mail", "armor", 5, 150));
     items.push_back(Item("Plate Armor", "armor", 8, 250));
 }
 
 void Shop::displayShop(Player* player) const {
-    std::cout << "\n" << Colors::BRIGHT_YELLOW;
-    std::cout << "╔════════════════════════════════════════════════════════════╗\n";
-    std::cout << "║              🛒 " << std::left << std::setw(22) << shopName << " 🛒              ║\n";
-    std::cout << "╠════════════════════════════════════════════════════════════╣\n";
-    std::cout << "║  " << Colors::WHITE << "💰 Your Gold: " << Colors::BRIGHT_YELLOW << std::setw(6) << player->getGold() << Colors::BRIGHT_YELLOW << "                                      ║\n";
-    std::cout << "╠════════════════════════════════════════════════════════════╣\n";
-    std::cout << "║  " << Colors::CYAN << std::left << std::setw(24) << "ITEM" 
-              << std::setw(10) << "TYPE" 
-              << std::setw(8) << "PRICE" 
-              << std::setw(12) << "EFFECT" << Colors::BRIGHT_YELLOW << " ║\n";
-    std::cout << "╠────────────────────────────────────────────────────────────╣\n" << Colors::RESET;
-    
-    for (size_t i = 0; i < items.size(); i++) {
-        std::cout << Colors::BRIGHT_YELLOW << "║  ";
-        
-        // Icon based on type
-        if (items[i].type == "potion") {
-            std::cout << "🧪 ";
-        } else if (items[i].type == "weapon") {
-            std::cout << "⚔️  ";
-        } else if (items[i].type == "armor") {
-            std::cout << "🛡️  ";
-        } else {
-            std::cout << "📦 ";
-        }
-        
-        std::cout << Colors::WHITE << std::left << std::setw(20) << items[i].name;
-        
+    Trace::Span span("Shop::displayShop");
+    // Shop name and gold
+    static const Ui::Template header(std::string("\n") + Colors::BRIGHT_YELLOW +
+        "╔════════════════════════════════════════════════════════════╗\n"
+        "║{^60}║\n"
+        "╠════════════════════════════════════════════════════════════╣\n"
+        "║  " + Colors::WHITE + "💰 Your Gold: " + Colors::BRIGHT_YELLOW + "{}" + Colors::BRIGHT_YELLOW + "{@61}║\n"
+        "╠════════════════════════════════════════════════════════════╣\n"
+        "║  " + Colors::CYAN + Ui::left("ITEM", 23).str() + Ui::left("TYPE", 10).str() + Ui::left("PRICE", 8).str() + "EFFECT" +
+            Colors::BRIGHT_YELLOW + "{@61}║\n"
+        "╠────────────────────────────────────────────────────────────╣\n" + Colors::RESET);
+    // Icon, name, type color and name, price, effect color, value and what it raises
+    static const Ui::Template itemRow(std::string(Colors::BRIGHT_YELLOW) + "║  {}" + Colors::WHITE + "{20}{}{10}" +
+        Colors::YELLOW + "{8}{}+{3}{}" + Colors::BRIGHT_YELLOW + "{@61}║\n" + Colors::RESET);
+    static const Ui::Template footer(std::string(Colors::BRIGHT_YELLOW) +
+        "╚════════════════════════════════════════════════════════════╝\n" + Colors::RESET);
+
+    Ui::Text title;
+    title << "🛒 " << shopName << " 🛒";
+    header.render(Console::out(), {title, player->getGold()});
+    for (const Item& item : items) {
         // Type with color coding
-        if (items[i].type == "potion") {
-            std::cout << Colors::GREEN << std::setw(10) << "Potion";
-        } else if (items[i].type == "weapon") {
-            std::cout << Colors::RED << std::setw(10) << "Weapon";
-        } else if (items[i].type == "armor") {
-            std::cout << Colors::BLUE << std::setw(10) << "Armor";
+        if (item.type == "potion") {
+            itemRow.render(Console::out(), {"🧪 ", item.name, Colors::GREEN, "Potion", item.price, Colors::GREEN, item.value, " HP/MP"});
+        } else if (item.type == "weapon") {
+            itemRow.render(Console::out(), {"⚔️ ", item.name, Colors::RED, "Weapon", item.price, Colors::RED, item.value, " ATK"});
+        } else if (item.type == "armor") {
+            itemRow.render(Console::out(), {"🛡️ ", item.name, Colors::BLUE, "Armor", item.price, Colors::BLUE, item.value, " DEF"});
         } else {
-            std::cout << Colors::WHITE << std::setw(10) << items[i].type;
+            itemRow.render(Console::out(), {"📦 ", item.name, Colors::WHITE, item.type, item.price, Colors::CYAN, item.value, " stat"});
         }
-        
-        std::cout << Colors::YELLOW << std::setw(8) << items[i].price;
-        
-        // Effect description
-        if (items[i].type == "potion") {
-            std::cout << Colors::GREEN << "+" << std::setw(3) << items[i].value << " HP/MP";
-        } else {
-            std::cout << Colors::CYAN << "+" << std::setw(3) << items[i].value << " stat";
-        }
-        
-        std::cout << Colors::BRIGHT_YELLOW << "  ║\n" << Colors::RESET;
     }
-    
-    std::cout << Colors::BRIGHT_YELLOW;
-    std::cout << "╚════════════════════════════════════════════════════════════╝\n" << Colors::RESET;
+    footer.render(Console::out());
 }
 
 bool Shop::buyItem(Player* player, const std::string& itemName) {
+    Trace::Span span("Shop::buyItem");
     auto it = std::find_if(items.begin(), items.end(),
         [&itemName](const Item& item) { return item.name == itemName; });
     
     if (it != items.end()) {
         if (player->spendGold(it->price)) {
             player->addItem(*it);
-            std::cout << Colors::BRIGHT_GREEN << "✅ You bought " << it->name << " for " << it->price << " gold!\n" << Colors::RESET;
+            Console::out() << Colors::BRIGHT_GREEN << "✅ You bought " << it->name << " for " << it->price << " gold!\n" << Colors::RESET;
             return true;
         } else {
-            std::cout << Colors::BRIGHT_RED << "❌ You don't have enough gold!\n" << Colors::RESET;
+            Console::out() << Colors::BRIGHT_RED << "❌ You don't have enough gold!\n" << Colors::RESET;
             return false;
         }
     } else {
-        std::cout << Colors::BRIGHT_RED << "❌ Item not found in shop.\n" << Colors::RESET;
+        Console::out() << Colors::BRIGHT_RED << "❌ Item not found in shop.\n" << Colors::RESET;
         return false;
     }
 }
@@ -16,6 +16,7 @@ public:
     void displayShop(Player* player) const;
     bool buyItem(Player* player, const std::string& itemName);
     void addItem(const Item& item);
+    const std::vector<Item>& getItems() const { return items; }
 };
 
 #endif
@@ -0,0 +1,281 @@
+#include "Terminal.h"
+#include "Ui.h"
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include <poll.h>
+
+namespace Terminal {
+    namespace {
+        // EMOJI glyphs are replaced below RICH; SYMBOL glyphs only in PLAIN
+        enum class Kind { EMOJI, SYMBOL };
+
+        struct Glyph {
+            uint32_t codepoint;
+            Kind kind;
+            const char* ascii;
+        };
+
+        // Replacements keep the glyph's width: emoji take two columns, so
+        // they become two characters (or one where the text already pads
+        // them with a space), and map emoji become the ASCII map's letters.
+        const Glyph GLYPHS[] = {
+            // Box drawing, blocks and markers
+            {0x2550, Kind::SYMBOL, "="}, {0x2551, Kind::SYMBOL, "|"}, {0x2554, Kind::SYMBOL, "+"},
+            {0x2557, Kind::SYMBOL, "+"}, {0x255A, Kind::SYMBOL, "+"}, {0x255D, Kind::SYMBOL, "+"},
+            {0x2560, Kind::SYMBOL, "+"}, {0x2563, Kind::SYMBOL, "+"}, {0x2500, Kind::SYMBOL, "-"},
+            {0x2502, Kind::SYMBOL, "|"}, {0x250C, Kind::SYMBOL, "+"}, {0x2510, Kind::SYMBOL, "+"},
+            {0x2514, Kind::SYMBOL, "+"}, {0x2518, Kind::SYMBOL, "+"}, {0x251C, Kind::SYMBOL, "+"},
+            {0x2524, Kind::SYMBOL, "+"}, {0x256D, Kind::SYMBOL, "+"}, {0x256E, Kind::SYMBOL, "+"},
+            {0x2570, Kind::SYMBOL, "+"}, {0x256F, Kind::SYMBOL, "+"}, {0x2588, Kind::SYMBOL, "#"},
+            {0x2591, Kind::SYMBOL, "."}, {0x25B2, Kind::SYMBOL, "^"}, {0x25C6, Kind::SYMBOL, "*"},
+            {0x25CF, Kind::SYMBOL, "o"}, {0x25A0, Kind::SYMBOL, "#"}, {0x2605, Kind::SYMBOL, "*"},
+            {0x2606, Kind::SYMBOL, "T"}, {0x2726, Kind::SYMBOL, "C"}, {0x2713, Kind::SYMBOL, "v"},
+            {0x27A4, Kind::SYMBOL, ">"}, {0x279C, Kind::SYMBOL, ">"}, {0x00B7, Kind::SYMBOL, "."},
+            {0x00D7, Kind::SYMBOL, "x"}, {0x00B1, Kind::SYMBOL, "+-"}, {0x2014, Kind::SYMBOL, "-"},
+
+            // Emoji that carry meaning
+            {0x1F33F, Kind::EMOJI, ". "}, {0x1F9F1, Kind::EMOJI, "##"}, {0x1F3D8, Kind::EMOJI, "T"},
+            {0x1F332, Kind::EMOJI, "F "}, {0x1F3DC, Kind::EMOJI, "D"}, {0x26F0, Kind::EMOJI, "M"},
+            {0x1F4A7, Kind::EMOJI, "~ "}, {0x1F573, Kind::EMOJI, "*"}, {0x1F3F0, Kind::EMOJI, "C "},
+            {0x2B50, Kind::EMOJI, "@ "}, {0x2694, Kind::EMOJI, "X"}, {0x1F6E1, Kind::EMOJI, "]"},
+            {0x1F5E1, Kind::EMOJI, "/"}, {0x2764, Kind::EMOJI, "<3"}, {0x1F499, Kind::EMOJI, "<3"},
+            {0x1F49A, Kind::EMOJI, "<3"}, {0x1F4B0, Kind::EMOJI, "$ "}, {0x1F48E, Kind::EMOJI, "<>"},
+            {0x1F9EA, Kind::EMOJI, "! "}, {0x2705, Kind::EMOJI, "+ "}, {0x274C, Kind::EMOJI, "x "},
+            {0x2753, Kind::EMOJI, "? "}, {0x26A0, Kind::EMOJI, "!"}, {0x1F480, Kind::EMOJI, "x("},
+            {0x1F3C6, Kind::EMOJI, "**"}, {0x2B06, Kind::EMOJI, "^"}, {0x2B07, Kind::EMOJI, "v"},
+            {0x2B05, Kind::EMOJI, "<"}, {0x27A1, Kind::EMOJI, ">"}, {0x2139, Kind::EMOJI, "i"},
+
+            // Presentation selectors and joiners vanish with the emoji
+            {0xFE0F, Kind::EMOJI, ""}, {0xFE0E, Kind::EMOJI, ""}, {0x200D, Kind::EMOJI, ""},
+        };
+
+        typedef std::unordered_map<uint32_t, const char*> GlyphTable;
+
+        std::vector<GlyphTable> buildTables() {
+            std::vector<GlyphTable> tables(4);
+            for (const Glyph& glyph : GLYPHS) {
+                tables[static_cast<int>(Tier::PLAIN)][glyph.codepoint] = glyph.ascii;
+                if (glyph.kind == Kind::EMOJI) {
+                    tables[static_cast<int>(Tier::BASIC)][glyph.codepoint] = glyph.ascii;
+                }
+            }
+            return tables;
+        }
+
+        // Built once, the first time any output is filtered
+        const GlyphTable& glyphTable(Tier tier) {
+            static const std::vector<GlyphTable> tables = buildTables();
+            return tables[static_cast<int>(tier)];
+        }
+
+        bool isEmoji(uint32_t codepoint) {
+            return codepoint >= 0x1F000 || (codepoint >= 0x2600 && codepoint < 0x27C0) ||
+                   (codepoint >= 0x2B00 && codepoint < 0x2C00);
+        }
+
+        bool keepsColor(Tier tier) {
+            return tier == Tier::RICH || tier == Tier::BASIC;
+        }
+
+        bool contains(const std::string& text, const char* part) {
+            return text.find(part) != std::string::npos;
+        }
+
+        std::string environment(const char* name) {
+            const char* value = std::getenv(name);
+            return value ? value : "";
+        }
+    }
+
+    const char* tierName(Tier tier) {
+        switch (tier) {
+            case Tier::RICH: return "rich";
+            case Tier::BASIC: return "basic";
+            case Tier::MONO: return "mono";
+            case Tier::PLAIN: return "plain";
+        }
+        return "plain";
+    }
+
+    bool parseTier(const std::string& name, Tier& tier) {
+        for (Tier candidate : {Tier::RICH, Tier::BASIC, Tier::MONO, Tier::PLAIN}) {
+            if (name == tierName(candidate)) {
+                tier = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Tier fromTerm(const std::string& term, const std::string& colorTerm) {
+        if (term.empty() || term == "dumb" || term.compare(0, 2, "vt") == 0) {
+            return Tier::PLAIN;
+        }
+        if (colorTerm == "truecolor" || colorTerm == "24bit" || contains(term, "256color") ||
+            contains(term, "xterm") || contains(term, "screen") || contains(term, "tmux") ||
+            contains(term, "rxvt") || contains(term, "kitty") || contains(term, "alacritty")) {
+            return Tier::RICH;
+        }
+        // linux, ansi, cons25 and the like: colors but no emoji font
+        return Tier::BASIC;
+    }
+
+    Tier detect(int fd) {
+        Tier tier;
+        if (parseTier(environment("ARKANIA_TERM"), tier)) {
+            return tier;
+        }
+        if (!isatty(fd)) {
+            return Tier::PLAIN;
+        }
+        tier = fromTerm(environment("TERM"), environment("COLORTERM"));
+        if (!environment("NO_COLOR").empty()) {
+            return tier == Tier::RICH ? Tier::MONO : Tier::PLAIN;
+        }
+        return tier;
+    }
+
+    bool outputBehind(int fd) {
+        pollfd output;
+        output.fd = fd;
+        output.events = POLLOUT;
+        output.revents = 0;
+        return poll(&output, 1, 0) == 0;
+    }
+
+    void FilterBuffer::emitEscape() {
+        // MONO keeps cursor movement and screen clearing, only colors go
+        bool color = partial.size() > 2 && partial[1] == '[' && partial.back() == 'm';
+        if (keepsColor(tier) || (tier == Tier::MONO && !color)) {
+            converted += partial;
+        }
+        partial.clear();
+    }
+
+    void FilterBuffer::emitCharacter() {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(partial.data());
+        uint32_t codepoint;
+        if (partial.size() == 2) {
+            codepoint = ((bytes[0] & 0x1Fu) << 6) | (bytes[1] & 0x3Fu);
+        } else if (partial.size() == 3) {
+            codepoint = ((bytes[0] & 0x0Fu) << 12) | ((bytes[1] & 0x3Fu) << 6) | (bytes[2] & 0x3Fu);
+        } else {
+            codepoint = ((bytes[0] & 0x07u) << 18) | ((bytes[1] & 0x3Fu) << 12) |
+                        ((bytes[2] & 0x3Fu) << 6) | (bytes[3] & 0x3Fu);
+        }
+
+        const GlyphTable& table = glyphTable(tier);
+        GlyphTable::const_iterator found = table.find(codepoint);
+        const char* replacement = nullptr;
+        if (found != table.end()) {
+            replacement = found->second;
+        } else if (tier == Tier::PLAIN) {
+            replacement = isEmoji(codepoint) ? "* " : "?";
+        } else if (tier == Tier::BASIC && isEmoji(codepoint)) {
+            replacement = "* ";
+        }
+        if (!replacement) {
+            converted += partial;
+        }
+        partial.clear();
+
+        // Cells the character takes in the rich tier (see Ui::width)
+        int cells = Ui::width(codepoint);
+        if (codepoint == 0x200D) {
+            joined = true;
+        } else if (codepoint == 0xFE0F) {
+            cells = lastCells == 1 ? 1 : 0;
+            lastCells = 2;
+        } else if (cells > 0 && joined) {
+            cells = 0; // drawn as part of the emoji it is joined to
+            joined = false;
+            if (replacement) {
+                return;
+            }
+        } else if (cells > 0) {
+            lastCells = cells;
+        }
+        if (!replacement) {
+            owed = 0;
+            return;
+        }
+        // A replacement fills the same cells, so boxes laid out for the
+        // rich tier still line up; one that is wider is made up later in
+        // the same emoji (its variation selector) where possible
+        converted += replacement;
+        int spaces = cells - static_cast<int>(std::strlen(replacement)) - owed;
+        owed = spaces < 0 ? -spaces : 0;
+        converted.append(std::max(0, spaces), ' ');
+    }
+
+    void FilterBuffer::convert(const char* data, size_t size) {
+        converted.clear();
+        for (size_t i = 0; i < size; i++) {
+            char c = data[i];
+            unsigned char byte = static_cast<unsigned char>(c);
+            if (!partial.empty() && partial[0] == '\033') {
+                partial += c;
+                // ESC [ parameters... final byte, or ESC and one character
+                bool finished = partial.size() == 2 ? c != '[' : (byte >= 0x40 && byte <= 0x7E);
+                if (finished || partial.size() > 32) {
+                    emitEscape();
+                }
+            } else if (!partial.empty()) {
+                if ((byte & 0xC0) != 0x80) {
+                    // Truncated character: replace it and look at this byte afresh
+                    converted += tier == Tier::PLAIN ? "?" : partial;
+                    partial.clear();
+                    i--;
+                    continue;
+                }
+                partial += c;
+                unsigned char lead = static_cast<unsigned char>(partial[0]);
+                size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : 2;
+                if (partial.size() == length) {
+                    emitCharacter();
+                }
+            } else if (c == '\033' || byte >= 0xC0) {
+                partial = c;
+            } else if (byte >= 0x80) {
+                converted += tier == Tier::PLAIN ? '?' : c; // stray continuation byte
+            } else {
+                // Plain ASCII runs are copied whole
+                size_t end = i + 1;
+                while (end < size && static_cast<unsigned char>(data[end]) < 0x80 && data[end] != '\033') {
+                    end++;
+                }
+                converted.append(data + i, end - i);
+                i = end - 1;
+                lastCells = 1;
+                owed = 0;
+                joined = false;
+            }
+        }
+    }
+
+    int FilterBuffer::overflow(int c) {
+        if (c == traits_type::eof()) {
+            return traits_type::not_eof(c);
+        }
+        char ch = traits_type::to_char_type(c);
+        return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+    }
+
+    std::streamsize FilterBuffer::xsputn(const char* data, std::streamsize count) {
+        if (tier == Tier::RICH && partial.empty()) {
+            return destination->sputn(data, count);
+        }
+        convert(data, static_cast<size_t>(count));
+        std::streamsize size = static_cast<std::streamsize>(converted.size());
+        return destination->sputn(converted.data(), size) == size ? count : 0;
+    }
+
+    int FilterBuffer::sync() {
+        return destination->pubsync();
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+#include <string>
+#include <streambuf>
+
+// What the reader's terminal can show. The game always writes colors,
+// box drawing and emoji; a FilterBuffer in front of the real output turns
+// that into what the tier supports, using replacement tables built once
+// per tier.
+namespace Terminal {
+    enum class Tier {
+        RICH,    // 16+ colors, Unicode and emoji (xterm-256color, truecolor)
+        BASIC,   // 16 colors and box drawing, no emoji (the Linux console)
+        MONO,    // Unicode and emoji without colors (NO_COLOR)
+        PLAIN    // ASCII text only: pipes, logs, TERM=dumb
+    };
+
+    const char* tierName(Tier tier);
+    // "rich", "basic", "mono" or "plain"
+    bool parseTier(const std::string& name, Tier& tier);
+
+    // From TERM and COLORTERM values alone (as a remote client reports them)
+    Tier fromTerm(const std::string& term, const std::string& colorTerm);
+    // For output on fd: ARKANIA_TERM if set, else PLAIN unless fd is a
+    // terminal, else NO_COLOR, TERM and COLORTERM
+    Tier detect(int fd);
+    // True when fd would not take a write right now: whoever reads it (a
+    // slow terminal or SSH link) has not caught up with what was written
+    bool outputBehind(int fd);
+
+    // Passes everything through for RICH; otherwise drops escape sequences
+    // the tier has no use for and replaces glyphs it cannot show, padding
+    // each replacement to the cells the glyph takes so boxes still line up.
+    // Sequences split across writes are held until they are complete.
+    class FilterBuffer : public std::streambuf {
+    private:
+        std::streambuf* destination;
+        Tier tier;
+        std::string partial;   // an incomplete escape sequence or UTF-8 character
+        std::string converted;
+        int lastCells;   // rich-tier cells of the last character shown
+        int owed;        // cells a replacement took beyond the character's
+        bool joined;     // a zero-width joiner came last
+
+
+        void convert(const char* data, size_t size);
+        void emitEscape();
+        void emitCharacter();
+
+    protected:
+        int overflow(int c) override;
+        std::streamsize xsputn(const char* data, std::streamsize count) override;
+        int sync() override;
+
+    public:
+        FilterBuffer(std::streambuf* output, Tier outputTier)
+            : destination(output), tier(outputTier), lastCells(0), owed(0), joined(false) {}
+
+        Tier getTier() const { return tier; }
+        void setTier(Tier outputTier) { tier = outputTier; }
+    };
+}
+
+#endif
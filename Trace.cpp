@@ -0,0 +1,161 @@
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+
+namespace Trace {
+    static const uint64_t RING_SIZE = 1 << 17; // spans kept per thread
+
+    struct Slot {
+        std::atomic<const char*> name;
+        std::atomic<uint64_t> start;     // nanoseconds since the process started
+        std::atomic<uint64_t> duration;
+    };
+
+    // One thread's spans. The owner fills slot head % RING_SIZE and then
+    // publishes it by bumping head; readers copy without stopping it.
+    struct Ring {
+        int thread;
+        std::atomic<uint64_t> head;
+        std::vector<Slot> slots;
+
+        explicit Ring(int number) : thread(number), head(0), slots(RING_SIZE) {}
+    };
+
+    static std::atomic<bool> enabled(false);
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    // Rings are never freed: a thread that exits hands its ring (spans and
+    // all) to the next thread that starts tracing
+    static std::mutex registryMutex;
+    static std::vector<Ring*> everyRing;
+    static std::vector<Ring*> unusedRings;
+
+    namespace {
+        struct ThreadRing {
+            Ring* ring;
+
+            ThreadRing() {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                if (!unusedRings.empty()) {
+                    ring = unusedRings.back();
+                    unusedRings.pop_back();
+                } else {
+                    ring = new Ring(static_cast<int>(everyRing.size()) + 1);
+                    everyRing.push_back(ring);
+                }
+            }
+            ~ThreadRing() {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                unusedRings.push_back(ring);
+            }
+        };
+    }
+
+    static Ring& mine() {
+        static thread_local ThreadRing local;
+        return *local.ring;
+    }
+
+    static uint64_t sinceEpoch(std::chrono::steady_clock::time_point when) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(when - epoch).count());
+    }
+
+    void setEnabled(bool on) {
+        enabled.store(on, std::memory_order_relaxed);
+    }
+
+    bool isEnabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void record(const char* name, std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end) {
+        Ring& ring = mine();
+        uint64_t index = ring.head.load(std::memory_order_relaxed);
+        Slot& slot = ring.slots[index % RING_SIZE];
+        uint64_t begin = sinceEpoch(start);
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.start.store(begin, std::memory_order_relaxed);
+        slot.duration.store(sinceEpoch(end) - begin, std::memory_order_relaxed);
+        ring.head.store(index + 1, std::memory_order_release);
+    }
+
+    namespace {
+        struct Event {
+            const char* name;
+            int thread;
+            uint64_t start;
+            uint64_t duration;
+        };
+    }
+
+    // Copy a ring while its thread keeps writing. Spans the writer may have
+    // reached again during the copy are dropped rather than returned torn.
+    static void copyRing(Ring& ring, std::vector<Event>& events) {
+        uint64_t end = ring.head.load(std::memory_order_acquire);
+        uint64_t begin = end > RING_SIZE ? end - RING_SIZE : 0;
+        size_t first = events.size();
+        for (uint64_t i = begin; i < end; i++) {
+            Slot& slot = ring.slots[i % RING_SIZE];
+            Event event;
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.thread = ring.thread;
+            event.start = slot.start.load(std::memory_order_relaxed);
+            event.duration = slot.duration.load(std::memory_order_relaxed);
+            events.push_back(event);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = ring.head.load(std::memory_order_relaxed);
+        if (after + 1 > begin + RING_SIZE) {
+            size_t overwritten = static_cast<size_t>(std::min<uint64_t>(after + 1 - RING_SIZE - begin, end - begin));
+            events.erase(events.begin() + first, events.begin() + first + overwritten);
+        }
+    }
+
+    long writeJson(const std::string& filename) {
+        std::vector<Event> events;
+        int threads;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            for (Ring* ring : everyRing) {
+                copyRing(*ring, events);
+            }
+            threads = static_cast<int>(everyRing.size());
+        }
+
+        std::ofstream file(filename.c_str(), std::ios::trunc);
+        if (!file) {
+            std::cerr << "Error: could not write trace " << filename << "\n";
+            return -1;
+        }
+        int pid = static_cast<int>(getpid());
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        file << std::fixed << std::setprecision(3);
+        const char* separator = "\n";
+        for (int t = 1; t <= threads; t++) {
+            file << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << t
+                 << ",\"args\":{\"name\":\"thread " << t << "\"}}";
+            separator = ",\n";
+        }
+        // Timestamps and durations are in microseconds
+        for (const Event& event : events) {
+            file << separator << "{\"name\":\"" << event.name << "\",\"cat\":\"game\",\"ph\":\"X\",\"pid\":"
+                 << pid << ",\"tid\":" << event.thread << ",\"ts\":" << event.start / 1e3
+                 << ",\"dur\":" << event.duration / 1e3 << "}";
+            separator = ",\n";
+        }
+        file << "\n]}\n";
+        file.close();
+        if (!file) {
+            std::cerr << "Error: could not write trace " << filename << "\n";
+            return -1;
+        }
+        return static_cast<long>(events.size());
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Timed spans around the expensive parts of the game (map loads, enemy
+// generation, battles, the shop, saving and loading, rendering), kept so a
+// capture can be opened in chrome://tracing or Perfetto. Each thread
+// writes completed spans into a ring buffer of its own, overwriting the
+// oldest, so recording never allocates or locks and can stay on in
+// production; writeJson() copies out whatever the rings hold.
+namespace Trace {
+    // Off by default; recording a span is a single load when disabled
+    void setEnabled(bool enabled);
+    bool isEnabled();
+
+    // name must outlive the process (a string literal)
+    void record(const char* name, std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end);
+
+    // Records its own lifetime under the name
+    class Span {
+    private:
+        const char* name;
+        bool active;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit Span(const char* spanName) : name(spanName), active(isEnabled()) {
+            if (active) {
+                start = std::chrono::steady_clock::now();
+            }
+        }
+        ~Span() {
+            if (active) {
+                record(name, start, std::chrono::steady_clock::now());
+            }
+        }
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+    };
+
+    // Write every buffered span as Chrome trace-event JSON; returns the
+    // number written, or -1 (with a message on std::cerr) if the file
+    // could not be written
+    long writeJson(const std::string& filename);
+}
+
+#endif
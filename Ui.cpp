@@ -0,0 +1,385 @@
+#include "Ui.h"
+#include <cstring>
+#include <unordered_map>
+#include <algorithm>
+
+namespace Ui {
+    namespace {
+        struct Range {
+            uint32_t first;
+            uint32_t last;
+        };
+
+        // Combining marks, zero-width spaces and joiners, variation
+        // selectors, skin tones and tags
+        const Range ZERO_WIDTH[] = {
+            {0x0300, 0x036F}, {0x0483, 0x0489}, {0x0591, 0x05BD}, {0x0610, 0x061A}, {0x064B, 0x065F},
+            {0x0E31, 0x0E31}, {0x0E34, 0x0E3A}, {0x0E47, 0x0E4E}, {0x1160, 0x11FF}, {0x1AB0, 0x1AFF},
+            {0x1DC0, 0x1DFF}, {0x200B, 0x200F}, {0x202A, 0x202E}, {0x2060, 0x2064}, {0x20D0, 0x20FF},
+            {0xFE00, 0xFE0F}, {0xFE20, 0xFE2F}, {0xFEFF, 0xFEFF}, {0x1F3FB, 0x1F3FF}, {0xE0000, 0xE0FFF},
+        };
+
+        // East Asian wide and fullwidth, and emoji shown as emoji by default
+        const Range DOUBLE_WIDTH[] = {
+            {0x1100, 0x115F}, {0x231A, 0x231B}, {0x2329, 0x232A}, {0x23E9, 0x23EC}, {0x23F0, 0x23F0},
+            {0x23F3, 0x23F3}, {0x25FD, 0x25FE}, {0x2614, 0x2615}, {0x2648, 0x2653}, {0x267F, 0x267F},
+            {0x2693, 0x2693}, {0x26A1, 0x26A1}, {0x26AA, 0x26AB}, {0x26BD, 0x26BE}, {0x26C4, 0x26C5},
+            {0x26CE, 0x26CE}, {0x26D4, 0x26D4}, {0x26EA, 0x26EA}, {0x26F2, 0x26F3}, {0x26F5, 0x26F5},
+            {0x26FA, 0x26FA}, {0x26FD, 0x26FD}, {0x2705, 0x2705}, {0x270A, 0x270B}, {0x2728, 0x2728},
+            {0x274C, 0x274C}, {0x274E, 0x274E}, {0x2753, 0x2755}, {0x2757, 0x2757}, {0x2795, 0x2797},
+            {0x27B0, 0x27B0}, {0x27BF, 0x27BF}, {0x2B1B, 0x2B1C}, {0x2B50, 0x2B50}, {0x2B55, 0x2B55},
+            {0x2E80, 0x303E}, {0x3041, 0x33FF}, {0x3400, 0x4DBF}, {0x4E00, 0x9FFF}, {0xA000, 0xA4CF},
+            {0xA960, 0xA97F}, {0xAC00, 0xD7A3}, {0xF900, 0xFAFF}, {0xFE10, 0xFE19}, {0xFE30, 0xFE6F},
+            {0xFF00, 0xFF60}, {0xFFE0, 0xFFE6}, {0x1F004, 0x1F004}, {0x1F0CF, 0x1F0CF}, {0x1F18E, 0x1F18E},
+            {0x1F191, 0x1F19A}, {0x1F200, 0x1F2FF}, {0x1F300, 0x1F320}, {0x1F32D, 0x1F335}, {0x1F337, 0x1F37C},
+            {0x1F37E, 0x1F393}, {0x1F3A0, 0x1F3CA}, {0x1F3CF, 0x1F3D3}, {0x1F3E0, 0x1F3F0}, {0x1F3F4, 0x1F3F4},
+            {0x1F3F8, 0x1F43E}, {0x1F440, 0x1F440}, {0x1F442, 0x1F4FC}, {0x1F4FF, 0x1F53D}, {0x1F54B, 0x1F54E},
+            {0x1F550, 0x1F567}, {0x1F57A, 0x1F57A}, {0x1F595, 0x1F596}, {0x1F5A4, 0x1F5A4}, {0x1F5FB, 0x1F64F},
+            {0x1F680, 0x1F6C5}, {0x1F6CC, 0x1F6CC}, {0x1F6D0, 0x1F6D2}, {0x1F6D5, 0x1F6DF}, {0x1F6EB, 0x1F6EC},
+            {0x1F6F4, 0x1F6FF}, {0x1F7E0, 0x1F7EB}, {0x1F90C, 0x1F93A}, {0x1F93C, 0x1F945}, {0x1F947, 0x1F9FF},
+            {0x1FA70, 0x1FAFF}, {0x20000, 0x2FFFD}, {0x30000, 0x3FFFD},
+        };
+
+        template <size_t N>
+        bool contains(const Range (&ranges)[N], uint32_t codepoint) {
+            const Range* found = std::lower_bound(ranges, ranges + N, codepoint,
+                [](const Range& range, uint32_t value) { return range.last < value; });
+            return found != ranges + N && found->first <= codepoint;
+        }
+
+        const size_t MAX_CACHED = 4096;
+
+        // Past an escape sequence starting at text[i]: ESC [ ... final byte,
+        // ESC ] ... BEL or ESC \, or ESC and one character
+        size_t skipEscape(const char* text, size_t length, size_t i) {
+            if (i + 1 >= length) {
+                return length;
+            }
+            char kind = text[i + 1];
+            i += 2;
+            if (kind == '[') {
+                while (i < length && !(text[i] >= 0x40 && text[i] <= 0x7E)) {
+                    i++;
+                }
+                return std::min(i + 1, length);
+            }
+            if (kind == ']') {
+                while (i < length && text[i] != '\a' && !(text[i] == '\033' && i + 1 < length && text[i + 1] == '\\')) {
+                    i++;
+                }
+                return std::min(i + (i < length && text[i] == '\033' ? 2 : 1), length);
+            }
+            return i;
+        }
+
+        int measure(const char* text, size_t length) {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text);
+            int cells = 0;
+            int last = 0;        // cells of the last character that took any
+            bool joined = false; // a zero-width joiner came after it
+            size_t i = 0;
+            while (i < length) {
+                unsigned char lead = bytes[i];
+                if (lead == 0x1B) {
+                    i = skipEscape(text, length, i);
+                    continue;
+                }
+                size_t count = lead < 0x80 ? 1 : lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 0;
+                uint32_t codepoint = count == 1 ? lead : count == 2 ? lead & 0x1Fu : count == 3 ? lead & 0x0Fu : lead & 0x07u;
+                bool valid = count > 0 && i + count <= length;
+                for (size_t k = 1; valid && k < count; k++) {
+                    valid = (bytes[i + k] & 0xC0) == 0x80;
+                    codepoint = (codepoint << 6) | (bytes[i + k] & 0x3Fu);
+                }
+                if (!valid) {
+                    cells++; // a stray byte shows as one replacement character
+                    last = 1;
+                    joined = false;
+                    i++;
+                    continue;
+                }
+                i += count;
+
+                if (codepoint == 0x200D) {
+                    joined = true;
+                } else if (codepoint == 0xFE0F && last == 1) {
+                    cells++; // emoji style
+                    last = 2;
+                } else if (codepoint == 0xFE0E && last == 2) {
+                    cells--; // text style
+                    last = 1;
+                } else {
+                    int cellsOf = width(codepoint);
+                    if (cellsOf > 0 && !joined) {
+                        cells += cellsOf;
+                        last = cellsOf;
+                    }
+                    if (cellsOf > 0) {
+                        joined = false; // part of the joined emoji before it
+                    }
+                }
+            }
+            return cells;
+        }
+
+        // Digits of a number, written backwards from the end of the buffer
+        size_t formatNumber(int number, char* end) {
+            unsigned int magnitude = number < 0 ? 0u - static_cast<unsigned int>(number) : static_cast<unsigned int>(number);
+            char* digit = end;
+            do {
+                *--digit = static_cast<char>('0' + magnitude % 10);
+                magnitude /= 10;
+            } while (magnitude);
+            if (number < 0) {
+                *--digit = '-';
+            }
+            return static_cast<size_t>(end - digit);
+        }
+    }
+
+    int width(uint32_t codepoint) {
+        if (codepoint < 0x20 || (codepoint >= 0x7F && codepoint < 0xA0)) {
+            return 0;
+        }
+        if (codepoint < 0x300) {
+            return 1;
+        }
+        if (contains(ZERO_WIDTH, codepoint)) {
+            return 0;
+        }
+        return contains(DOUBLE_WIDTH, codepoint) ? 2 : 1;
+    }
+
+    int width(const char* text, size_t length) {
+        // Printable ASCII is a cell a byte; nothing to look up
+        size_t i = 0;
+        while (i < length && static_cast<unsigned char>(text[i]) >= 0x20 && static_cast<unsigned char>(text[i]) < 0x7F) {
+            i++;
+        }
+        if (i == length) {
+            return static_cast<int>(length);
+        }
+
+        static thread_local std::unordered_map<std::string, int> cache;
+        static thread_local std::string key;
+        key.assign(text, length);
+        std::unordered_map<std::string, int>::const_iterator found = cache.find(key);
+        if (found != cache.end()) {
+            return found->second;
+        }
+        int cells = measure(text, length);
+        if (cache.size() >= MAX_CACHED) {
+            cache.clear(); // screens draw a bounded set of strings; start over
+        }
+        cache.emplace(key, cells);
+        return cells;
+    }
+
+    int width(const std::string& text) {
+        return width(text.data(), text.size());
+    }
+
+    std::string Cell::str() const {
+        std::string laidOut;
+        int spaces = std::max(0, cells - width(text, length));
+        int before = centered ? spaces / 2 : 0;
+        laidOut.reserve(length + spaces);
+        laidOut.append(before, ' ');
+        laidOut.append(text, length);
+        laidOut.append(spaces - before, ' ');
+        return laidOut;
+    }
+
+    Cell left(const std::string& text, int cells) {
+        return Cell{text.data(), text.size(), cells, false};
+    }
+
+    Cell left(const char* text, int cells) {
+        return Cell{text, std::strlen(text), cells, false};
+    }
+
+    Cell center(const std::string& text, int cells) {
+        return Cell{text.data(), text.size(), cells, true};
+    }
+
+    Cell center(const char* text, int cells) {
+        return Cell{text, std::strlen(text), cells, true};
+    }
+
+    std::ostream& operator<<(std::ostream& out, const Cell& cell) {
+        static const char SPACES[] = "                                                                ";
+        int spaces = std::max(0, cell.cells - width(cell.text, cell.length));
+        int before = cell.centered ? spaces / 2 : 0;
+        int after = spaces - before;
+        for (; before > 0; before -= static_cast<int>(sizeof(SPACES) - 1)) {
+            out.write(SPACES, std::min(before, static_cast<int>(sizeof(SPACES) - 1)));
+        }
+        out.write(cell.text, static_cast<std::streamsize>(cell.length));
+        for (; after > 0; after -= static_cast<int>(sizeof(SPACES) - 1)) {
+            out.write(SPACES, std::min(after, static_cast<int>(sizeof(SPACES) - 1)));
+        }
+        return out;
+    }
+
+    void Text::append(const char* data, size_t count) {
+        if (spill.empty() && length + count <= INLINE) {
+            std::memcpy(inlineData + length, data, count);
+        } else {
+            if (spill.empty()) {
+                spill.assign(inlineData, length);
+            }
+            spill.append(data, count);
+        }
+        length += count;
+    }
+
+    Text& Text::operator<<(const char* text) {
+        append(text, std::strlen(text));
+        return *this;
+    }
+
+    Text& Text::operator<<(const std::string& text) {
+        append(text.data(), text.size());
+        return *this;
+    }
+
+    Text& Text::operator<<(char c) {
+        append(&c, 1);
+        return *this;
+    }
+
+    Text& Text::operator<<(int number) {
+        char digits[12];
+        size_t count = formatNumber(number, digits + sizeof(digits));
+        append(digits + sizeof(digits) - count, count);
+        return *this;
+    }
+
+    Value::Value(const char* value)
+        : kind(Kind::TEXT), text(value), length(std::strlen(value)), number(0), bar() {}
+
+    Template::Template(const std::string& source) : slots(0) {
+        literals.reserve(source.size());
+        size_t begin = 0;       // of the literal text since the last slot
+        size_t lineStart = 0;   // of the current line, in `literals`
+        bool lineHasValue = false;
+        size_t i = 0;
+        while (i < source.size()) {
+            // "{" ["^" | "@"] digits "}" is a slot; any other brace is text
+            size_t close = i + 1;
+            char kind = close < source.size() && (source[close] == '^' || source[close] == '@') ? source[close++] : 0;
+            size_t digits = close;
+            while (source[i] == '{' && close < source.size() && source[close] >= '0' && source[close] <= '9') {
+                close++;
+            }
+            if (source[i] != '{' || close >= source.size() || source[close] != '}' || (kind && close == digits)) {
+                literals += source[i];
+                if (source[i++] == '\n') {
+                    lineStart = literals.size();
+                    lineHasValue = false;
+                }
+                continue;
+            }
+            int width = close > digits ? std::stoi(source.substr(digits, close - digits)) : 0;
+            i = close + 1;
+
+            if (kind == '@' && !lineHasValue) {
+                // Nothing on the line changes, so its padding is known now
+                int column = Ui::width(literals.data() + lineStart, literals.size() - lineStart);
+                literals.append(std::max(0, width - column), ' ');
+                continue;
+            }
+            size_t lineBreak = literals.find_last_of('\n', literals.size() - 1);
+            bool newline = lineBreak != std::string::npos && lineBreak >= begin && literals.size() > begin;
+            size_t cellsFrom = newline ? lineBreak + 1 : begin;
+            Slot slot = kind == '@' ? Slot::COLUMN : kind == '^' ? Slot::CENTER : Slot::LEFT;
+            pieces.push_back(Piece{begin, literals.size(), newline,
+                                   Ui::width(literals.data() + cellsFrom, literals.size() - cellsFrom),
+                                   slot, width, false});
+            begin = literals.size();
+            if (slot != Slot::COLUMN) {
+                slots++;
+                lineHasValue = true;
+            }
+        }
+        pieces.push_back(Piece{begin, literals.size(), false, 0, Slot::END, 0, false});
+
+        // A value is only measured when its slot has a width or a column
+        // stop later on its line needs to know where it ended
+        bool columnAhead = false;
+        for (size_t p = pieces.size(); p-- > 0;) {
+            Piece& piece = pieces[p];
+            if (piece.slot == Slot::COLUMN) {
+                columnAhead = true;
+            } else if (piece.slot != Slot::END) {
+                piece.measure = piece.width > 0 || columnAhead;
+            }
+            if (piece.newline) {
+                columnAhead = false;
+            }
+        }
+    }
+
+    void Template::render(std::ostream& out, std::initializer_list<Value> values) const {
+        // The screen is put together here and written at once; the buffer
+        // keeps its capacity, so after the first draw nothing is allocated
+        static thread_local std::string screen;
+        screen.clear();
+        const Value* value = values.begin();
+        int column = 0;
+        for (const Piece& piece : pieces) {
+            screen.append(literals, piece.literalBegin, piece.literalEnd - piece.literalBegin);
+            column = piece.newline ? piece.literalCells : column + piece.literalCells;
+            if (piece.slot == Slot::END) {
+                break;
+            }
+            if (piece.slot == Slot::COLUMN) {
+                screen.append(std::max(0, piece.width - column), ' ');
+                column = std::max(column, piece.width);
+                continue;
+            }
+
+            // The value's text: numbers are formatted first so a centered
+            // one can be measured before it is written
+            char digits[12];
+            const char* text = "";
+            size_t length = 0;
+            const Colors::Bar* bar = nullptr;
+            if (value != values.end()) {
+                switch (value->kind) {
+                    case Value::Kind::TEXT:
+                        text = value->text;
+                        length = value->length;
+                        break;
+                    case Value::Kind::NUMBER:
+                        length = formatNumber(value->number, digits + sizeof(digits));
+                        text = digits + sizeof(digits) - length;
+                        break;
+                    case Value::Kind::BAR:
+                        bar = &value->bar;
+                        break;
+                }
+                ++value;
+            }
+            int cells = 0;
+            if (piece.measure) {
+                cells = bar ? width(bar->glyphs, bar->length) + 2 : width(text, length);
+            }
+            int spaces = std::max(0, piece.width - cells);
+            int before = piece.slot == Slot::CENTER ? spaces / 2 : 0;
+            screen.append(before, ' ');
+            if (bar) {
+                screen += bar->color;
+                screen += '[';
+                screen.append(bar->glyphs, bar->length);
+                screen += ']';
+                screen += Colors::RESET;
+            } else {
+                screen.append(text, length);
+            }
+            screen.append(spaces - before, ' ');
+            column += cells + spaces;
+        }
+        out.write(screen.data(), static_cast<std::streamsize>(screen.size()));
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef UI_H
+#define UI_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <initializer_list>
+#include <cstdint>
+#include "Colors.h"
+
+// Screens drawn from templates compiled once. A template is the screen's
+// text with its colors and borders already in place and slots where the
+// values go: "{}" writes a value as is, "{N}" pads it with spaces to N
+// terminal cells and "{^N}" centers it in N cells (a longer value is not
+// cut), and "{@N}" pads the line itself out to column N, which is how a
+// box row reaches its right border whatever came before it. Drawing
+// copies the literal text, formats the few values, and hands the whole
+// screen to the stream in one write.
+//
+// Widths are terminal cells, not bytes: escape sequences take none, wide
+// (CJK) and emoji-style characters two, and combining marks, zero-width
+// joiners and skin tones none, so a joined emoji is as wide as its first
+// part. A variation selector switches the symbol before it to emoji style
+// (U+FE0F, two cells) or text style (U+FE0E, one).
+namespace Ui {
+    // Cells one character takes up on its own (0, 1 or 2)
+    int width(uint32_t codepoint);
+    // Cells the text takes up. Each distinct string is measured once per
+    // thread and cached; plain ASCII is counted without the cache.
+    int width(const char* text, size_t length);
+    int width(const std::string& text);
+
+    // Text laid out in a number of cells, for streaming or for building a
+    // template: spaces after it (left) or around it (center) fill the
+    // cells. Refers to the text, so use it within the same expression.
+    struct Cell {
+        const char* text;
+        size_t length;
+        int cells;
+        bool centered;
+
+        std::string str() const;
+    };
+    Cell left(const std::string& text, int cells);
+    Cell left(const char* text, int cells);
+    Cell center(const std::string& text, int cells);
+    Cell center(const char* text, int cells);
+    std::ostream& operator<<(std::ostream& out, const Cell& cell);
+
+    // Text built from parts without allocating, for a slot that shows more
+    // than one value ("45/60"). Longer text than fits inline spills to the heap.
+    class Text {
+    private:
+        static const size_t INLINE = 96;
+        char inlineData[INLINE];
+        size_t length;
+        std::string spill;
+
+        void append(const char* data, size_t count);
+
+    public:
+        Text() : length(0) {}
+        Text(const Text&) = delete;
+        Text& operator=(const Text&) = delete;
+
+        Text& operator<<(const char* text);
+        Text& operator<<(const std::string& text);
+        Text& operator<<(char c);
+        Text& operator<<(int number);
+
+        const char* data() const { return spill.empty() ? inlineData : spill.data(); }
+        size_t size() const { return length; }
+    };
+
+    // One slot's value; made implicitly from what the screens show
+    struct Value {
+        enum class Kind { TEXT, NUMBER, BAR };
+
+        Kind kind;
+        const char* text;
+        size_t length;
+        int number;
+        Colors::Bar bar;
+
+        Value(const char* value);
+        Value(const std::string& value) : kind(Kind::TEXT), text(value.data()), length(value.size()), number(0), bar() {}
+        Value(const Text& value) : kind(Kind::TEXT), text(value.data()), length(value.size()), number(0), bar() {}
+        Value(const char* value, size_t count) : kind(Kind::TEXT), text(value), length(count), number(0), bar() {}
+        Value(int value) : kind(Kind::NUMBER), text(nullptr), length(0), number(value), bar() {}
+        Value(const Colors::Bar& value) : kind(Kind::BAR), text(nullptr), length(0), number(0), bar(value) {}
+    };
+
+    class Template {
+    private:
+        enum class Slot { LEFT, CENTER, COLUMN, END };
+
+        struct Piece {
+            size_t literalBegin;   // literal text before the slot, in `literals`
+            size_t literalEnd;
+            bool newline;          // the literal text has a line break
+            int literalCells;      // cells of the literal after its last newline
+            Slot slot;
+            int width;             // cells of the slot, or the column to pad to
+            bool measure;          // a width or column depends on this value's width
+        };
+
+        std::string literals;
+        std::vector<Piece> pieces;
+        size_t slots;
+
+    public:
+        explicit Template(const std::string& source);
+
+        size_t slotCount() const { return slots; }
+        // Values fill the slots in order; a slot without one is left empty
+        void render(std::ostream& out, std::initializer_list<Value> values = {}) const;
+    };
+}
+
+#endif
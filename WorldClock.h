@@ -0,0 +1,24 @@
+#ifndef WORLDCLOCK_H
+#define WORLDCLOCK_H
+
+#include <cstdint>
+
+// World time for one game, counted in fixed ticks. Only actions that take
+// time in the world advance it (a step on the map); looking at menus or
+// typing an invalid command does not. Nothing runs on a tick: time-based
+// effects remember the tick they were last brought up to date and work out
+// what has elapsed when they are read, so an idle game costs nothing.
+class WorldClock {
+private:
+    uint64_t ticks;
+
+public:
+    static const uint64_t TICKS_PER_MOVE = 1;
+
+    WorldClock() : ticks(0) {}
+
+    uint64_t now() const { return ticks; }
+    void advance(uint64_t count) { ticks += count; }
+};
+
+#endif
@@ -0,0 +1,264 @@
+// Micro-benchmarks for the game's core subsystems. Build and run with
+// ./bench.sh; see usage() for the options.
+#include "Benchmark.h"
+#include "Game.h"
+#include "Map.h"
+#include "Player.h"
+#include "Enemy.h"
+#include "Battle.h"
+#include "Shop.h"
+#include "Colors.h"
+#include "Console.h"
+#include "CommandSource.h"
+#include "SaveFormat.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <cstdlib>
+
+static const char* const REGIONS[] = {"Verdant Woods", "Scorched Dunes", "Frost Peaks", "Dark Citadel"};
+
+// Keeps results alive so the compiler cannot drop the work that made them
+static volatile long sinkValue;
+
+static int usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--filter TEXT] [--repetitions N] [--warmup N]"
+              << " [--target-ms MS] [--json FILE] [--maps DIR]\n";
+    return 1;
+}
+
+static void addMapCases(Benchmark& bench, const std::string& mapsDir, NullSink& sink) {
+    for (const char* region : REGIONS) {
+        std::string file = mapsDir + "/" + region + ".txt";
+        bench.add(std::string("map/load/") + region, [file] {
+            Map map;
+            sinkValue = map.loadFromFile(file) ? map.getWidth() : 0;
+        });
+    }
+
+    std::shared_ptr<Map> map = std::make_shared<Map>();
+    if (!map->loadFromFile(mapsDir + "/Scorched Dunes.txt")) {
+        map->generateDefaultMap("Scorched Dunes");
+    }
+    bench.add("map/getTileAt sweep", [map] {
+        long sum = 0;
+        for (int y = 0; y < map->getHeight(); y++) {
+            for (int x = 0; x < map->getWidth(); x++) {
+                sum += map->getTileAt(x, y);
+            }
+        }
+        sinkValue = sum;
+    });
+    bench.add("map/canMoveTo sweep", [map] {
+        long open = 0;
+        for (int y = -1; y <= map->getHeight(); y++) {
+            for (int x = -1; x <= map->getWidth(); x++) {
+                open += map->canMoveTo(x, y);
+            }
+        }
+        sinkValue = open;
+    });
+
+    for (const char* region : {"Verdant Woods", "Scorched Dunes"}) {
+        std::shared_ptr<Map> shown = std::make_shared<Map>();
+        if (!shown->loadFromFile(mapsDir + "/" + region + ".txt")) {
+            shown->generateDefaultMap(region);
+        }
+        std::string suffix = std::string(" ") + region;
+        bench.add("render/Map::display" + suffix, [shown] { shown->display(1, 1); }, &sink);
+        bench.add("render/Map::displayStyled" + suffix, [shown] { shown->displayStyled(1, 1, true); }, &sink);
+        bench.add("render/Map::displayFull" + suffix, [shown] { shown->displayFull(); }, &sink);
+        bench.add("render/Map::displayMinimap" + suffix, [shown] { shown->displayMinimap(5, 5); }, &sink);
+    }
+
+    // A generated region far larger than the hand-made ones, filled a chunk
+    // at a time the way loading a save does
+    std::shared_ptr<Map> world = std::make_shared<Map>();
+    world->resize("Generated", 4096, 4096);
+    std::string payload;
+    for (int chunk = 0; chunk < world->getChunkCount(); chunk++) {
+        int startX = (chunk % world->getChunksX()) * Map::CHUNK_SIZE;
+        int startY = (chunk / world->getChunksX()) * Map::CHUNK_SIZE;
+        payload.clear();
+        for (int y = startY; y < startY + Map::CHUNK_SIZE; y++) {
+            for (int x = startX; x < startX + Map::CHUNK_SIZE; x++) {
+                payload += "..FF.DMW"[((x / 97) ^ (y / 61)) % 8];
+            }
+        }
+        world->readChunk(chunk, SaveFormat::StringView(payload.data(), payload.size()));
+    }
+    world->setTile(2048, 1365, 'T');
+    world->setTile(300, 3900, '~');
+    world->setTile(4000, 4000, 'C');
+    bench.add("render/Map::displayOverview 4096x4096", [world] { world->displayOverview(2048, 2048); }, &sink);
+    bench.add("map/setTile 4096x4096", [world] {
+        static int step = 0;
+        step++;
+        world->setTile(step % 4096, 7, (step & 1) ? 'M' : '.');
+    });
+}
+
+static void addRenderCases(Benchmark& bench, NullSink& sink) {
+    std::shared_ptr<Player> player = std::make_shared<Player>("Bench", PlayerClass::WARRIOR);
+    player->addItem(Item("Health Potion", "potion", 30, 20));
+    std::shared_ptr<Shop> shop = std::make_shared<Shop>("General Store");
+    std::shared_ptr<Enemy> enemy = std::make_shared<Enemy>("Goblin", 3, "Verdant Woods");
+
+    bench.add("render/Player::displayStats", [player] { player->displayStats(); }, &sink);
+    bench.add("render/Player::displayInventory", [player] { player->displayInventory(); }, &sink);
+    bench.add("render/Shop::displayShop", [shop, player] { shop->displayShop(player.get()); }, &sink);
+    bench.add("render/Enemy::displayStats", [enemy] { enemy->displayStats(); }, &sink);
+    bench.add("render/Battle::begin", [player, enemy] {
+        Battle battle(player.get(), enemy.get());
+        battle.begin(); // status screen and action menu
+    }, &sink);
+
+    bench.add("colors/healthBar", [] {
+        static int hp = 0;
+        hp = (hp + 7) % 101;
+        sinkValue = static_cast<long>(Colors::healthBar(hp, 100, 20).size());
+    });
+    bench.add("colors/manaBar", [] {
+        static int mp = 0;
+        mp = (mp + 7) % 51;
+        sinkValue = static_cast<long>(Colors::manaBar(mp, 50, 20).size());
+    });
+    bench.add("colors/healthBarView streamed", [] {
+        static int hp = 0;
+        hp = (hp + 7) % 101;
+        Console::out() << Colors::healthBarView(hp, 100, 20);
+    }, &sink);
+}
+
+// Screens drawn by a game in progress, through the same commands a player types
+static void addGameCases(Benchmark& bench, NullSink& sink) {
+    std::shared_ptr<QueueSource> input = std::make_shared<QueueSource>();
+    std::shared_ptr<Game> game = std::make_shared<Game>(*input);
+    game->disableSaving();
+    game->start();
+    for (const char* line : {"1", "Bench", "1", ""}) {
+        game->feed(line); // new warrior, past the intro
+    }
+    if (game->getPrompt() != Game::Prompt::COMMAND) {
+        std::cerr << "Warning: could not start a game; skipping game cases\n";
+        return;
+    }
+
+    bench.add("render/Game actions menu", [input, game] { game->feed(""); }, &sink);
+    bench.add("render/Game map command", [input, game] { game->feed("M"); }, &sink);
+    bench.add("render/Game help command", [input, game] { game->feed("H"); }, &sink);
+    bench.add("enemy/generateRandomEnemy", [input, game] {
+        Enemy* enemy = game->generateRandomEnemy();
+        sinkValue = enemy->getMaxHealth();
+        delete enemy;
+    });
+}
+
+static void addBattleCases(Benchmark& bench, NullSink& sink) {
+    bench.add("battle/resolve attack-only", [] {
+        Player player("Bench", PlayerClass::WARRIOR);
+        Enemy enemy("Goblin", 1, "Verdant Woods");
+        Battle battle(&player, &enemy);
+        battle.begin();
+        for (int turn = 0; turn < 1000 && !battle.isOver(); turn++) {
+            battle.feed("1");
+        }
+        sinkValue = battle.playerWon();
+    }, &sink);
+    bench.add("enemy/construct", [] {
+        static int index = 0;
+        const char* region = REGIONS[index++ % 4];
+        Enemy enemy("Dark Knight", 1 + index % 20, region);
+        sinkValue = enemy.getMaxHealth();
+    });
+}
+
+static void addSaveCases(Benchmark& bench, const std::string& mapsDir) {
+    std::shared_ptr<Player> player = std::make_shared<Player>("Bench", PlayerClass::MAGE);
+    player->addItem(Item("Health Potion", "potion", 30, 20));
+    player->addItem(Item("Mana Potion", "potion", 25, 15));
+
+    bench.add("save/player round trip", [player] {
+        SaveFormat::Writer writer;
+        player->writeSections(writer);
+        const std::string& image = writer.finish();
+        SaveFormat::SaveFile save;
+        Player loaded("", PlayerClass::WARRIOR);
+        sinkValue = save.parseBuffer(image.data(), image.size()) && loaded.readSections(save);
+    });
+
+    std::shared_ptr<Map> map = std::make_shared<Map>();
+    if (!map->loadFromFile(mapsDir + "/Verdant Woods.txt")) {
+        map->generateDefaultMap("Verdant Woods");
+    }
+    std::shared_ptr<Map> copy = std::make_shared<Map>();
+    copy->resize("Verdant Woods", map->getWidth(), map->getHeight());
+    bench.add("save/map chunks round trip", [map, copy] {
+        SaveFormat::Writer writer;
+        for (int chunk = 0; chunk < map->getChunkCount(); chunk++) {
+            writer.beginSection(1, static_cast<uint32_t>(chunk));
+            map->writeChunk(chunk, writer);
+            writer.endSection();
+        }
+        const std::string& image = writer.finish();
+        SaveFormat::SaveFile save;
+        bool ok = save.parseBuffer(image.data(), image.size());
+        for (int chunk = 0; ok && chunk < copy->getChunkCount(); chunk++) {
+            ok = copy->readChunk(chunk, save.getSection(1, static_cast<uint32_t>(chunk)));
+        }
+        sinkValue = ok;
+    });
+}
+
+int main(int argc, char* argv[]) {
+    Benchmark::Options options;
+    std::string jsonFile;
+    std::string mapsDir = "maps";
+    for (int i = 1; i < argc; i += 2) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            return usage(argv[0]);
+        }
+        std::string value = argv[i + 1];
+        if (flag == "--filter") {
+            options.filter = value;
+        } else if (flag == "--repetitions") {
+            options.repetitions = std::atoi(value.c_str());
+        } else if (flag == "--warmup") {
+            options.warmup = std::atoi(value.c_str());
+        } else if (flag == "--target-ms") {
+            options.targetMs = std::atof(value.c_str());
+        } else if (flag == "--json") {
+            jsonFile = value;
+        } else if (flag == "--maps") {
+            mapsDir = value;
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (options.repetitions <= 0 || options.warmup < 0 || options.targetMs <= 0) {
+        return usage(argv[0]);
+    }
+
+    // Everything the game prints goes to the sink, fully formatted
+    NullSink sink;
+    std::ostream sinkStream(&sink);
+    Colors::setAnimationsEnabled(false);
+    Console::redirect(&sinkStream);
+
+    Benchmark bench(options);
+    addMapCases(bench, mapsDir, sink);
+    addRenderCases(bench, sink);
+    addGameCases(bench, sink);
+    addBattleCases(bench, sink);
+    addSaveCases(bench, mapsDir);
+
+    bench.run(std::cerr);
+    Console::redirect(nullptr);
+    std::cout << "\n";
+    bench.writeTable(std::cout);
+    if (!jsonFile.empty() && !bench.writeJson(jsonFile)) {
+        return 1;
+    }
+    return 0;
+}
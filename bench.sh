@@ -0,0 +1,13 @@
+#!/bin/bash
+# Build and run the micro-benchmarks; arguments go to the benchmark
+# (e.g. ./bench.sh --filter render --json bench.json)
+
+cd "$(dirname "$0")"
+echo "🔨 Building benchmarks..."
+g++ -std=c++11 -O2 -pthread -o arkania_bench bench.cpp Benchmark.cpp Player.cpp Enemy.cpp Battle.cpp Map.cpp Shop.cpp Game.cpp Colors.cpp CommandSource.cpp Console.cpp SaveFormat.cpp SaveStore.cpp AutoSave.cpp Latency.cpp Trace.cpp Animation.cpp Ui.cpp Terminal.cpp
+
+if [ $? -eq 0 ]; then
+    ./arkania_bench "$@"
+else
+    echo "❌ Build failed!"
+fi
@@ -1,9 +1,168 @@
 #include "Game.h"
+#include "CommandSource.h"
+#include "Server.h"
+#include "Agent.h"
+#include "Trace.h"
+#include "Terminal.h"
 #include <iostream>
+#include <string>
+#include <cstdlib>
+#include <unistd.h>
+
+static std::string traceFile;
+
+static int usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--trace FILE] [--script FILE | --keys]\n"
+              << "       " << program << " [--trace FILE] --server [--workers N] [--stats-interval S] [--term TIER] [--animations] [watch:]unix:PATH|[watch:]tcp:PORT [...]\n"
+              << "       " << program << " [--trace FILE] --playthroughs N [--threads T] [--agent scripted|random] [--max-steps S]\n";
+    return 1;
+}
+
+// Host games for clients connecting to each given address; addresses
+// prefixed with watch: take spectators instead of players
+static int runServer(int argc, char* argv[]) {
+    int first = 2;
+    int workers = 0;       // one per core
+    int statsInterval = 0; // no periodic stats
+    Terminal::Tier tier = Terminal::Tier::RICH;
+    bool animations = false;
+    while (first + 1 < argc && std::string(argv[first]).compare(0, 2, "--") == 0) {
+        std::string flag = argv[first];
+        if (flag == "--animations") {
+            animations = true;
+            first++;
+            continue;
+        }
+        int value = std::atoi(argv[first + 1]);
+        if (flag == "--workers" && value > 0) {
+            workers = value;
+        } else if (flag == "--stats-interval" && value > 0) {
+            statsInterval = value;
+        } else if (flag == "--term" && Terminal::parseTier(argv[first + 1], tier)) {
+            // sessions start with this tier
+        } else {
+            return usage(argv[0]);
+        }
+        first += 2;
+    }
+    if (first >= argc) {
+        return usage(argv[0]);
+    }
+
+    Server server(static_cast<size_t>(workers));
+    if (statsInterval > 0) {
+        server.setStatsInterval(statsInterval);
+    }
+    if (Trace::isEnabled()) {
+        server.setTraceFile(traceFile);
+    }
+    server.setDefaultTier(tier);
+    server.setAnimations(animations);
+    for (int i = first; i < argc; i++) {
+        std::string address = argv[i];
+        bool spectators = address.compare(0, 6, "watch:") == 0;
+        std::string where = spectators ? address.substr(6) : address;
+        bool ok;
+        if (where.compare(0, 5, "unix:") == 0) {
+            ok = server.listenUnix(where.substr(5), spectators);
+        } else if (where.compare(0, 4, "tcp:") == 0) {
+            ok = server.listenTcp(std::atoi(where.c_str() + 4), spectators);
+        } else {
+            return usage(argv[0]);
+        }
+        if (!ok) {
+            std::cerr << "Error: " << server.getError() << "\n";
+            return 1;
+        }
+        std::cerr << "Listening on " << address << "\n";
+    }
+    server.run();
+    return 0;
+}
+
+// Benchmark: bots play complete games as fast as they can
+static int runPlaythroughBenchmark(int argc, char* argv[]) {
+    PlaythroughOptions options;
+    options.playthroughs = std::atoi(argv[2]);
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--threads") {
+            options.threads = std::atoi(argv[i + 1]);
+        } else if (flag == "--agent") {
+            options.agent = argv[i + 1];
+        } else if (flag == "--max-steps") {
+            options.maxSteps = std::atoi(argv[i + 1]);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (options.playthroughs <= 0 || options.maxSteps <= 0 || argc % 2 == 0) {
+        return usage(argv[0]);
+    }
+    return runPlaythroughs(options, std::cout) ? 0 : 1;
+}
+
+static int runMode(int argc, char* argv[]) {
+    if (argc >= 3 && std::string(argv[1]) == "--server") {
+        return runServer(argc, argv);
+    }
+    if (argc >= 3 && std::string(argv[1]) == "--playthroughs") {
+        return runPlaythroughBenchmark(argc, argv);
+    }
+
+    // --script FILE plays the commands in FILE instead of reading the terminal
+    if (argc == 3 && std::string(argv[1]) == "--script") {
+        ScriptSource script(argv[2]);
+        if (!script.isOpen()) {
+            std::cerr << "Error: could not open script " << argv[2] << "\n";
+            return 1;
+        }
+        Game game(script);
+        game.run();
+        return 0;
+    }
+    // --keys reads single keystrokes: W/A/S/D or the arrow keys move at once
+    if (argc == 2 && std::string(argv[1]) == "--keys") {
+        KeyboardSource keys;
+        if (!keys.isRaw()) {
+            std::cerr << "Error: --keys needs a terminal on standard input\n";
+            return 1;
+        }
+        Game game(keys);
+        game.run();
+        return 0;
+    }
+    if (argc > 1) {
+        return usage(argv[0]);
+    }
 
-int main() {
     Game game;
     game.run();
     return 0;
 }
 
+int main(int argc, char* argv[]) {
+    // --trace FILE records trace spans in any mode and writes them on exit
+    if (argc >= 3 && std::string(argv[1]) == "--trace") {
+        traceFile = argv[2];
+        Trace::setEnabled(true);
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
+    // Colors, box drawing and emoji only where the terminal can show them;
+    // ARKANIA_TERM=rich|basic|mono|plain overrides the detection
+    std::streambuf* console = std::cout.rdbuf();
+    Terminal::FilterBuffer terminal(console, Terminal::detect(STDOUT_FILENO));
+    std::cout.rdbuf(&terminal);
+    int status = runMode(argc, argv);
+    std::cout.flush();
+    std::cout.rdbuf(console);
+    if (Trace::isEnabled()) {
+        long spans = Trace::writeJson(traceFile);
+        if (spans >= 0) {
+            std::cerr << "Wrote " << spans << " trace spans to " << traceFile << "\n";
+        }
+    }
+    return status;
+}
@@ -3,7 +3,7 @@
 
 cd "$(dirname "$0")"
 echo "🔨 Building Legends of Arkania..."
-g++ -std=c++11 -O2 -o legends_of_arkania main.cpp Player.cpp Enemy.cpp Battle.cpp Map.cpp Shop.cpp Game.cpp Colors.cpp
+g++ -std=c++11 -O2 -pthread -o legends_of_arkania main.cpp Player.cpp Enemy.cpp Battle.cpp Map.cpp Shop.cpp Game.cpp Colors.cpp CommandSource.cpp Console.cpp SaveFormat.cpp SaveStore.cpp AutoSave.cpp Server.cpp Scheduler.cpp Agent.cpp Latency.cpp Trace.cpp Terminal.cpp Animation.cpp Ui.cpp
 
 if [ $? -eq 0 ]; then
     echo "✅ Build successful!"